@@ -1,49 +1,428 @@
+#include "decode.hpp"
 #include "encode.hpp"
+#include <algorithm>
 #include <chrono>
-#include <iostream>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
 #include <string>
 #include <string_view>
+#include <utility>
+#include <vector>
 
 using namespace std::string_view_literals;
 
-constexpr auto src =
-    "Lorem ipsum dolor sit amet, consectetur adipiscing elit. Nullam mollis imperdiet massa, at dapibus elit "
-    "interdumac. In eget sollicitudin mi. Nam at tellus at sapien tincidunt sollicitudin vel non eros. Pellentesque "
-    "nunc nunc,ullamcorper eu accumsan at, pulvinar non turpis. Quisque vel mauris pulvinar, pretium purus vel, "
-    "ultricies erat.Curabitur a magna in ligula tristique ornare. Quisque commodo, massa viverra laoreet luctus, sem "
-    "nisi aliquamvelit, fermentum pulvinar velit leo eget justo. Suspendisse vel erat efficitur, pulvinar eros "
-    "volutpat, vulputateex. Phasellus non purus vel velit tristique tristique id at ligula. Quisque mollis sodales "
-    "magna. Mauris et quameu quam viverra tempus. Nullam tempus maximus porta. Nunc mattis eleifend fermentum. Nullam "
-    "aliquam liberoaccumsan velit elementum, eu laoreet metus convallis. Donec pellentesque lacus ut iaculis iaculis. "
-    "Curabitur orcielit, bibendum sit amet feugiat at, iaculis sit amet massa. Maecenas imperdiet lacus at vehicula "
-    "iaculis. Donecvolutpat nunc sit amet accumsan tempor. Quisque pretium vestibulum ultricies. Suspendisse potenti. "
-    "Aenean at diamiaculis, condimentum felis venenatis, condimentum erat. Nam quis elit dui. Duis quis odio vitae "
-    "metus hendreritrhoncus ut et magna. Cras ac augue quis nibh pharetra sagittis. Donec ullamcorper vel eros semper "
-    "pretium. Proinvel sollicitudin eros. Nulla sollicitudin mattis turpis id suscipit. Aliquam sed risus velit. "
-    "Aliquam iaculis necnibh ac egestas. Duis finibus semper est sed consequat. Sed in sapien quis nibh dignissim "
-    "mattis. Vestibulum necmetus sodales, euismod mauris ac, sollicitudin libero. Maecenas non arcu ac velit "
-    "ullamcorper fringilla et quisnulla. Curabitur posuere leo eget ipsum tincidunt dignissim. Cras ultricies suscipit "
-    "neque, quis suscipit tortorvenenatis non. Cras nisl mi, bibendum in vulputate quis, vestibulum ornare enim. Nunc "
-    "hendrerit placerat dui,aliquam mollis sem convallis et. Integer vitae urna diam. Phasellus et imperdiet est. "
-    "Maecenas auctor facilisisnibh non commodo. Suspendisse iaculis quam "sv;
+// encode and decode throughput of every kind by input size
+// usage: benchmark [--csv | --json] [--max-size BYTES] [--reps N] [--filter SUBSTRING] [--latency]
+// GB/s counts the binary bytes in both directions, so rows are comparable
+// --latency instead reports the p50 and p99 ns per call of every size from 1
+// to 64 bytes, like UUIDs, digests and JWT headers
 
-int main()
+namespace
 {
-    std::string dest;
-    dest.resize((src.size() + 3) / 3 * 4);
+struct options
+{
+    enum class output_format
+    {
+        table,
+        csv,
+        json
+    } format{};
+    std::size_t max_size{std::size_t(256) << 20};
+    std::size_t reps{5};
+    std::string_view filter{};
+    bool latency{};
+};
+
+struct result
+{
+    std::string name;
+    std::size_t size;
+    std::size_t iters;
+    double median;
+    double stddev;
+};
+
+struct latency
+{
+    std::string name;
+    std::size_t size;
+    double p50;
+    double p99;
+};
+
+// largest size of the latency rows
+constexpr std::size_t latency_max_size = 64;
+
+constexpr std::size_t sizes[] = {8,
+                                 64,
+                                 512,
+                                 std::size_t(4) << 10,
+                                 std::size_t(32) << 10,
+                                 std::size_t(256) << 10,
+                                 std::size_t(2) << 20,
+                                 std::size_t(16) << 20,
+                                 std::size_t(256) << 20};
+
+// chunk sizes of the streaming rows, each is compared with the one-shot rows
+// of the same size
+constexpr std::size_t chunks[] = {std::size_t(1) << 10, std::size_t(4) << 10, std::size_t(16) << 10,
+                                  std::size_t(64) << 10};
+
+constexpr std::pair<std::string_view, bizwen::rfc4648_kind> kinds[] = {
+    {"base64"sv, bizwen::rfc4648_kind::base64},
+    {"base64_url"sv, bizwen::rfc4648_kind::base64_url},
+    {"base32"sv, bizwen::rfc4648_kind::base32},
+    {"base32_lower"sv, bizwen::rfc4648_kind::base32_lower},
+    {"base32_hex"sv, bizwen::rfc4648_kind::base32_hex},
+    {"base32_hex_lower"sv, bizwen::rfc4648_kind::base32_hex_lower},
+    {"base32_crockford"sv, bizwen::rfc4648_kind::base32_crockford},
+    {"base32_crockford_lower"sv, bizwen::rfc4648_kind::base32_crockford_lower},
+    {"base16"sv, bizwen::rfc4648_kind::base16},
+    {"base16_lower"sv, bizwen::rfc4648_kind::base16_lower},
+};
+
+// keeps the compiler from discarding the work that produced p
+inline void do_not_optimize(void const *p)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    static void const *volatile sink;
+    sink = p;
+#else
+    __asm__ volatile("" : : "r"(p) : "memory");
+#endif
+}
+
+// each repetition calls f enough times to run for about 10 ms
+template <typename F>
+result measure(std::string name, std::size_t size, std::size_t reps, F f)
+{
+    using clock = std::chrono::steady_clock;
+
+    auto time = [&f](std::size_t iters) {
+        auto pre = clock::now();
+
+        for (std::size_t i{}; i != iters; ++i)
+            f();
+
+        return std::chrono::duration<double, std::nano>(clock::now() - pre).count();
+    };
+
+    // warm up and calibrate
+    auto once = std::max(time(1), 1.0);
+    auto iters = static_cast<std::size_t>(std::max(1e7 / once, 1.0));
+
+    time(std::min(iters, std::size_t(1000)));
+
+    std::vector<double> samples;
+
+    for (std::size_t r{}; r != reps; ++r)
+        samples.push_back(time(iters) / static_cast<double>(iters));
+
+    std::ranges::sort(samples);
+
+    auto median = samples.size() % 2 ? samples[samples.size() / 2]
+                                     : (samples[samples.size() / 2 - 1] + samples[samples.size() / 2]) / 2;
+    double mean{};
+    double variance{};
+
+    for (auto s : samples)
+        mean += s / static_cast<double>(samples.size());
+    for (auto s : samples)
+        variance += (s - mean) * (s - mean) / static_cast<double>(samples.size());
+
+    return {std::move(name), size, iters, median, std::sqrt(variance)};
+}
+
+// each sample times a few back to back calls, a single call is close to the
+// resolution of the clock
+template <typename F>
+latency measure_latency(std::string name, std::size_t size, F f)
+{
+    using clock = std::chrono::steady_clock;
+
+    constexpr std::size_t calls = 16;
+
+    for (std::size_t i{}; i != 10000; ++i)
+        f();
+
+    std::vector<double> samples(20000);
+
+    for (auto &sample : samples)
+    {
+        auto pre = clock::now();
+
+        for (std::size_t i{}; i != calls; ++i)
+            f();
+
+        sample = std::chrono::duration<double, std::nano>(clock::now() - pre).count() / calls;
+    }
+
+    std::ranges::sort(samples);
+
+    return {std::move(name), size, samples[samples.size() / 2], samples[samples.size() * 99 / 100]};
+}
+
+void print(latency const &r, options::output_format format, bool first)
+{
+    if (format == options::output_format::table)
+        std::printf("%-40s %10zu %10.1f %10.1f\n", r.name.c_str(), r.size, r.p50, r.p99);
+    else if (format == options::output_format::csv)
+        std::printf("%s,%zu,%.3f,%.3f\n", r.name.c_str(), r.size, r.p50, r.p99);
+    else
+        std::printf("%s\n  {\"name\": \"%s\", \"size\": %zu, \"p50_ns\": %.3f, \"p99_ns\": %.3f}", first ? "" : ",",
+                    r.name.c_str(), r.size, r.p50, r.p99);
+
+    std::fflush(stdout);
+}
+
+void print(result const &r, options::output_format format, bool first)
+{
+    auto rate = static_cast<double>(r.size) / r.median;
+
+    if (format == options::output_format::table)
+        std::printf("%-40s %10zu %12.1f %10.1f %8.3f\n", r.name.c_str(), r.size, r.median, r.stddev, rate);
+    else if (format == options::output_format::csv)
+        std::printf("%s,%zu,%zu,%.3f,%.3f,%.6f\n", r.name.c_str(), r.size, r.iters, r.median, r.stddev, rate);
+    else
+        std::printf("%s\n  {\"name\": \"%s\", \"size\": %zu, \"iterations\": %zu, \"ns_per_call\": %.3f, "
+                    "\"ns_per_call_stddev\": %.3f, \"gb_per_s\": %.6f}",
+                    first ? "" : ",", r.name.c_str(), r.size, r.iters, r.median, r.stddev, rate);
+
+    std::fflush(stdout);
+}
+
+template <bizwen::rfc4648_kind Kind>
+void run_latency(std::string_view kind, options const &opts, std::vector<unsigned char> const &src, bool &first)
+{
+    char encoded[bizwen::rfc4648_encoded_size<Kind>(latency_max_size)];
+    unsigned char decoded[latency_max_size];
+
+    auto bench = [&](std::string_view name, std::size_t size, auto f) {
+        auto full = std::string(kind) + '/' + std::string(name);
+
+        if (full.find(opts.filter) == std::string::npos)
+            return;
+
+        print(measure_latency(std::move(full), size, f), opts.format, first);
+        first = false;
+    };
+
+    for (std::size_t size = 1; size <= latency_max_size; ++size)
+    {
+        auto begin = src.data();
+        auto end = begin + size;
+        auto chars = bizwen::rfc4648_encoded_size<Kind>(size);
+
+        bench("encode", size, [&] { do_not_optimize(bizwen::rfc4648_encode.operator()<Kind>(begin, end, encoded)); });
+        bench("decode", size, [&] {
+            do_not_optimize(bizwen::rfc4648_decode.operator()<Kind>(encoded, encoded + chars, decoded).out);
+        });
+    }
+}
+
+template <bizwen::rfc4648_kind Kind>
+void run(std::string_view kind, options const &opts, std::vector<unsigned char> const &src, bool &first)
+{
+    constexpr bool has_padding = bizwen::detail::get_family<Kind>() != bizwen::rfc4648_kind::base16;
+
+    std::vector<char> encoded(bizwen::rfc4648_encoded_size<Kind>(src.size()));
+    std::vector<unsigned char> decoded(src.size());
+
+    auto bench = [&](std::string_view name, std::size_t size, auto f) {
+        auto full = std::string(kind) + '/' + std::string(name);
+
+        if (full.find(opts.filter) == std::string::npos)
+            return;
+
+        print(measure(std::move(full), size, opts.reps, f), opts.format, first);
+        first = false;
+    };
+
+    for (auto size : sizes)
+    {
+        if (size > opts.max_size)
+            break;
+
+        auto begin = src.data();
+        auto end = begin + size;
+        auto chars = bizwen::rfc4648_encoded_size<Kind>(size);
+
+        bench("encode", size, [&] {
+            do_not_optimize(bizwen::rfc4648_encode.operator()<Kind>(begin, end, encoded.data()));
+        });
+
+        if constexpr (has_padding)
+        {
+            bench("encode_no_padding", size, [&] {
+                do_not_optimize(bizwen::rfc4648_encode.operator()<Kind, false>(begin, end, encoded.data()));
+            });
+        }
+
+        bench("encode_ctx", size, [&] {
+            bizwen::rfc4648_context ctx;
+            auto last = bizwen::rfc4648_encode.operator()<Kind>(ctx, begin, end, encoded.data());
+            do_not_optimize(bizwen::rfc4648_encode.operator()<Kind>(ctx, last));
+        });
+
+        // the input arrives in chunks, like reads from a socket
+        for (auto chunk : chunks)
+        {
+            if (chunk >= size)
+                break;
+
+            bench("encode_ctx_chunked_" + std::to_string(chunk >> 10) + "K", size, [&] {
+                bizwen::rfc4648_context ctx;
+                auto last = encoded.data();
+
+                for (auto p = begin; p != end;)
+                {
+                    auto next = p + std::min(chunk, static_cast<std::size_t>(end - p));
+
+                    last = bizwen::rfc4648_encode.operator()<Kind>(ctx, p, next, last);
+                    p = next;
+                }
+
+                do_not_optimize(bizwen::rfc4648_encode.operator()<Kind>(ctx, last));
+            });
+        }
+
+        // the scalar encoder with one lookup per char and with BIZWEN_RFC4648_B64_PAIR_TABLE
+        if constexpr (Kind == bizwen::rfc4648_kind::base64)
+        {
+            constexpr auto alphabet = bizwen::encode_impl::get_alphabet<Kind>();
+
+            bench("encode_scalar", size, [&] {
+                auto first = encoded.data();
+                bizwen::encode_impl::encode_impl_b64_scalar<Kind, true, false>(alphabet, begin, end, first);
+                do_not_optimize(first);
+            });
+            bench("encode_scalar_pair_table", size, [&] {
+                auto first = encoded.data();
+                bizwen::encode_impl::encode_impl_b64_scalar<Kind, true, true>(alphabet, begin, end, first);
+                do_not_optimize(first);
+            });
+        }
+
+        // decode the padded encoding written above
+        bizwen::rfc4648_encode.operator()<Kind>(begin, end, encoded.data());
+
+        auto in = encoded.data();
+
+        bench("decode", size, [&] {
+            do_not_optimize(bizwen::rfc4648_decode.operator()<Kind>(in, in + chars, decoded.data()).out);
+        });
+
+        bench("decode_ctx", size, [&] {
+            bizwen::rfc4648_context ctx;
+            auto [last, out] = bizwen::rfc4648_decode.operator()<Kind>(ctx, in, in + chars, decoded.data());
+            do_not_optimize(bizwen::rfc4648_decode.operator()<Kind>(ctx, out));
+        });
+
+        for (auto chunk : chunks)
+        {
+            if (chunk >= chars)
+                break;
+
+            bench("decode_ctx_chunked_" + std::to_string(chunk >> 10) + "K", size, [&] {
+                bizwen::rfc4648_context ctx;
+                auto out = decoded.data();
+
+                for (auto p = in; p != in + chars;)
+                {
+                    auto next = p + std::min(chunk, static_cast<std::size_t>(in + chars - p));
+
+                    out = bizwen::rfc4648_decode.operator()<Kind>(ctx, p, next, out).out;
+                    p = next;
+                }
+
+                do_not_optimize(bizwen::rfc4648_decode.operator()<Kind>(ctx, out));
+            });
+        }
+
+        bench("validate", size, [&] {
+            do_not_optimize(bizwen::rfc4648_validate.operator()<Kind>(in, in + chars).end);
+        });
+
+        if (!std::equal(begin, end, decoded.begin()) && opts.filter.empty())
+        {
+            std::fprintf(stderr, "%s: decoded %zu bytes differ\n", std::string(kind).c_str(), size);
+            std::exit(1);
+        }
+    }
+}
+
+template <std::size_t I = 0>
+void run_all(options const &opts, std::vector<unsigned char> const &src, bool &first)
+{
+    if constexpr (I != std::size(kinds))
+    {
+        if (opts.latency)
+            run_latency<kinds[I].second>(kinds[I].first, opts, src, first);
+        else
+            run<kinds[I].second>(kinds[I].first, opts, src, first);
+
+        run_all<I + 1>(opts, src, first);
+    }
+}
+
+[[noreturn]] void usage()
+{
+    std::fputs("usage: benchmark [--csv | --json] [--max-size BYTES] [--reps N] [--filter SUBSTRING] [--latency]\n",
+               stderr);
+    std::exit(1);
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    options opts;
+
+    for (int i = 1; i != argc; ++i)
+    {
+        std::string_view arg{argv[i]};
+
+        if (arg == "--csv"sv)
+            opts.format = options::output_format::csv;
+        else if (arg == "--json"sv)
+            opts.format = options::output_format::json;
+        else if (arg == "--max-size"sv && i + 1 != argc)
+            opts.max_size = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--reps"sv && i + 1 != argc)
+            opts.reps = std::max(std::strtoull(argv[++i], nullptr, 10), 1ull);
+        else if (arg == "--filter"sv && i + 1 != argc)
+            opts.filter = argv[++i];
+        else if (arg == "--latency"sv)
+            opts.latency = true;
+        else
+            usage();
+    }
+
+    std::vector<unsigned char> src(std::max(std::min(opts.max_size, sizes[std::size(sizes) - 1]), latency_max_size));
+
+    for (std::size_t i{}; i != src.size(); ++i)
+        src[i] = static_cast<unsigned char>(i * 7 + (i >> 8));
 
-    auto pre = std::chrono::steady_clock::now();
+    if (opts.format == options::output_format::json)
+        std::printf("[");
+    else if (opts.latency && opts.format == options::output_format::table)
+        std::printf("%-40s %10s %10s %10s\n", "name", "bytes", "p50 ns", "p99 ns");
+    else if (opts.latency)
+        std::printf("name,size,p50_ns,p99_ns\n");
+    else if (opts.format == options::output_format::table)
+        std::printf("%-40s %10s %12s %10s %8s\n", "name", "bytes", "ns/call", "stddev", "GB/s");
+    else
+        std::printf("name,size,iterations,ns_per_call,ns_per_call_stddev,gb_per_s\n");
 
-    for (std::size_t x{}; x < 100000; ++x)
-        auto it = bizwen::rfc4648_encode(src.begin(), src.end(), dest.begin());
+    bool first{true};
 
-    auto now = std::chrono::steady_clock::now();
+    run_all(opts, src, first);
 
-    std::cout << "bizwen::rfc4648_encode: " << std::chrono::duration_cast<std::chrono::milliseconds>((now - pre))
-              << '\n'
-              << dest << '\n';
+    if (opts.format == options::output_format::json)
+        std::printf("\n]\n");
 }
 
 /* simd base64 library:
 https://github.com/WojciechMula/base64simd
-*/
\ No newline at end of file
+*/
@@ -0,0 +1,132 @@
+#include "decode.hpp"
+#include "encode.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// ns per message of rfc4648_encode_batch and rfc4648_decode_batch against a
+// loop of single calls, on messages of random length like tokens and signatures
+// usage: benchmark_batch [messages = 10000] [min bytes = 16] [max bytes = 300]
+
+namespace
+{
+// keeps the compiler from discarding the work that produced p
+inline void do_not_optimize(void const *p)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    static void const *volatile sink;
+    sink = p;
+#else
+    __asm__ volatile("" : : "r"(p) : "memory");
+#endif
+}
+
+// best of 5 runs of f, in ns per message
+template <typename F>
+double measure(std::size_t messages, F f)
+{
+    f();
+
+    double best{};
+
+    for (int i{}; i != 5; ++i)
+    {
+        auto pre = std::chrono::steady_clock::now();
+
+        for (int j{}; j != 20; ++j)
+            f();
+
+        auto ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - pre).count() / 20 /
+                  static_cast<double>(messages);
+
+        best = i && best < ns ? best : ns;
+    }
+
+    return best;
+}
+
+template <bizwen::rfc4648_kind Kind>
+void run(char const *name, std::vector<std::string> const &messages)
+{
+    std::size_t chars{};
+
+    for (auto const &m : messages)
+        chars += bizwen::rfc4648_encoded_size<Kind>(m.size());
+
+    std::vector<char> arena(chars);
+    std::vector<std::size_t> sizes(messages.size());
+
+    auto encode_loop = measure(messages.size(), [&] {
+        auto first = arena.data();
+
+        for (std::size_t i{}; i != messages.size(); ++i)
+        {
+            auto last = bizwen::rfc4648_encode.operator()<Kind>(messages[i], first);
+            sizes[i] = static_cast<std::size_t>(last - first);
+            first = last;
+        }
+
+        do_not_optimize(first);
+    });
+    auto encode_batch = measure(messages.size(), [&] {
+        do_not_optimize(bizwen::rfc4648_encode_batch.operator()<Kind>(messages, arena.data(), sizes.data()));
+    });
+
+    std::vector<std::string_view> encoded;
+
+    for (std::size_t i{}, pos{}; i != messages.size(); pos += sizes[i], ++i)
+        encoded.emplace_back(arena.data() + pos, sizes[i]);
+
+    std::vector<unsigned char> decoded(chars);
+    std::vector<bizwen::rfc4648_decode_batch_result> results(messages.size());
+
+    auto decode_loop = measure(messages.size(), [&] {
+        auto first = decoded.data();
+
+        for (std::size_t i{}; i != encoded.size(); ++i)
+        {
+            auto [end, last] = bizwen::rfc4648_decode.operator()<Kind>(encoded[i], first);
+            results[i] = {static_cast<std::size_t>(end - encoded[i].begin()), static_cast<std::size_t>(last - first)};
+            first = last;
+        }
+
+        do_not_optimize(first);
+    });
+    auto decode_batch = measure(messages.size(), [&] {
+        do_not_optimize(bizwen::rfc4648_decode_batch.operator()<Kind>(encoded, decoded.data(), results.data()));
+    });
+
+    std::printf("%-12s %12.1f %12.1f %12.1f %12.1f\n", name, encode_loop, encode_batch, decode_loop, decode_batch);
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000;
+    std::size_t min = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 16;
+    std::size_t max = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 300;
+
+    std::mt19937_64 gen(1);
+    std::uniform_int_distribution<std::size_t> length(min, max);
+    std::vector<std::string> messages(count);
+
+    for (auto &m : messages)
+    {
+        m.resize(length(gen));
+
+        for (auto &c : m)
+            c = static_cast<char>(gen());
+    }
+
+    std::printf("ns per message, %zu messages of %zu to %zu bytes\n", count, min, max);
+    std::printf("%-12s %12s %12s %12s %12s\n", "kind", "encode loop", "encode batch", "decode loop", "decode batch");
+
+    run<bizwen::rfc4648_kind::base64>("base64", messages);
+    run<bizwen::rfc4648_kind::base64_url>("base64_url", messages);
+    run<bizwen::rfc4648_kind::base32>("base32", messages);
+    run<bizwen::rfc4648_kind::base16>("base16", messages);
+}
@@ -0,0 +1,63 @@
+#include "decode.hpp"
+#include "encode.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// encode and decode throughput of one large buffer by thread count, the
+// curve flattens where memory bandwidth is saturated
+// usage: benchmark_threads [MiB = 256] [max threads = 2 * hardware_concurrency]
+int main(int argc, char **argv)
+{
+    std::size_t size = (argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 256) << 20;
+    std::size_t max_threads = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : std::thread::hardware_concurrency() * 2;
+
+    std::vector<unsigned char> src(size);
+
+    for (std::size_t i{}; i != size; ++i)
+        src[i] = static_cast<unsigned char>(i * 7 + (i >> 8));
+
+    std::string encoded(bizwen::rfc4648_encoded_size(size), '\0');
+    std::string decoded(size, '\0');
+
+    auto measure = [size](auto &&f) {
+        // warm up, then take the best of 5 runs
+        f();
+
+        double best{};
+
+        for (int i{}; i != 5; ++i)
+        {
+            auto pre = std::chrono::steady_clock::now();
+            f();
+            std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - pre;
+            auto rate = static_cast<double>(size) / seconds.count() / 1e9;
+
+            best = rate > best ? rate : best;
+        }
+
+        return best;
+    };
+
+    std::cout << "threads, encode GB/s, decode GB/s (" << (size >> 20) << " MiB of input bytes)\n";
+
+    for (std::size_t threads = 1; threads <= max_threads; ++threads)
+    {
+        auto encode = measure([&] {
+            auto first = encoded.begin();
+            bizwen::encode_impl::encode_impl_parallel<bizwen::rfc4648_kind::base64, true>(
+                threads, src.data(), src.data() + src.size(), first);
+        });
+        auto decode = measure([&] {
+            auto first = decoded.begin();
+            bizwen::decode_impl::decode_impl_parallel<bizwen::rfc4648_kind::base64>(
+                threads, bizwen::decode_impl::get_table<bizwen::rfc4648_kind::base64>(), encoded.data(),
+                encoded.data() + encoded.size(), first);
+        });
+
+        std::cout << threads << ", " << encode << ", " << decode << '\n';
+    }
+}
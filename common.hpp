@@ -3,6 +3,10 @@
 #include <memory> // std::to_address
 #include <type_traits> // std::remove_reference
 #include <climits>
+#include <cstddef> // std::size_t
+#include <cstring> // std::memcpy
+#include <iterator> // std::contiguous_iterator
+#include <utility> // std::index_sequence
 
 static_assert(CHAR_BIT == 8);
 
@@ -28,7 +32,7 @@ enum class rfc4648_kind : unsigned char
 namespace detail
 {
 template <typename T>
-auto to_address_const(T t)
+constexpr auto to_address_const(T t)
 {
     auto ptr = std::to_address(t);
     using const_pointer = std::add_const_t<std::remove_reference_t<decltype(*t)>> *;
@@ -46,6 +50,164 @@ inline consteval auto get_family()
         return rfc4648_kind::base32;
 }
 
+// the output can be written through a plain byte pointer
+template <typename Out>
+concept narrow_contiguous_iterator =
+    std::contiguous_iterator<Out> && std::is_integral_v<std::iter_value_t<Out>> && sizeof(std::iter_value_t<Out>) == 1;
+
+// the output is a contiguous range of 16 or 32-bit chars, such as std::u16string
+template <typename Out>
+concept wide_contiguous_iterator =
+    std::contiguous_iterator<Out> && std::is_integral_v<std::iter_value_t<Out>> &&
+    (sizeof(std::iter_value_t<Out>) == 2 || sizeof(std::iter_value_t<Out>) == 4);
+
+// write the chars or bytes of buf to first, with one unaligned store when the
+// output is narrow and contiguous, so buf is built in registers and its loads
+// are not repeated after each store to a char that may alias them
+template <typename T, std::size_t N, typename O>
+inline constexpr void write_block(T const (&buf)[N], O &first)
+{
+    static_assert(sizeof(T) == 1);
+
+    if constexpr (narrow_contiguous_iterator<O>)
+    {
+#if defined(__cpp_if_consteval) && (__cpp_if_consteval >= 202106L)
+        if !consteval
+#else
+        if (!::std::is_constant_evaluated())
+#endif
+        {
+            std::memcpy(std::to_address(first), buf, N);
+            first += N;
+
+            return;
+        }
+    }
+
+    for (auto c : buf)
+    {
+        *first = c;
+        ++first;
+    }
+}
+
+// call f(std::integral_constant<std::size_t, I>{}) for I from 0 to Count - 1,
+// the calls are unrolled at compile time
+template <std::size_t Count, typename F>
+inline constexpr void unroll(F &&f)
+{
+    [&f]<std::size_t... I>(std::index_sequence<I...>) {
+        (f(std::integral_constant<std::size_t, I>{}), ...);
+    }(std::make_index_sequence<Count>{});
+}
+
+// number of chars encoding n bytes
+template <rfc4648_kind Kind, bool Padding>
+inline constexpr std::size_t encoded_size(std::size_t n) noexcept
+{
+    if constexpr (get_family<Kind>() == rfc4648_kind::base64)
+        return n / 3 * 4 + (n % 3 ? (Padding ? 4 : n % 3 + 1) : 0);
+    else if constexpr (get_family<Kind>() == rfc4648_kind::base32)
+        return n / 5 * 8 + (n % 5 ? (Padding ? 8 : (n % 5 * 8 + 4) / 5) : 0);
+    else
+        return n * 2;
+}
+
+// number of bytes decoded from n valid chars, the bits of an incomplete byte
+// are discarded except for base16
+template <rfc4648_kind Kind>
+inline constexpr std::size_t decoded_size(std::size_t n) noexcept
+{
+    if constexpr (get_family<Kind>() == rfc4648_kind::base64)
+        return n / 4 * 3 + n % 4 * 3 / 4;
+    else if constexpr (get_family<Kind>() == rfc4648_kind::base32)
+        return n / 8 * 5 + n % 8 * 5 / 8;
+    else
+        return n / 2 + n % 2;
+}
+
+// bytes and chars of a quantum
+template <rfc4648_kind Kind>
+inline constexpr std::size_t quantum_bytes = get_family<Kind>() == rfc4648_kind::base64   ? 3
+                                             : get_family<Kind>() == rfc4648_kind::base32 ? 5
+                                                                                          : 1;
+
+template <rfc4648_kind Kind>
+inline constexpr std::size_t quantum_chars = encoded_size<Kind, true>(quantum_bytes<Kind>);
+
+template <typename C>
+concept resize_and_overwrite_container =
+    requires(C &c) { c.resize_and_overwrite(std::size_t{}, [](auto, auto) { return std::size_t{}; }); };
+
+// size c to n elements, let fill write them through a raw pointer and shrink c
+// to the count fill returns, strings are not zero filled first
+template <typename C, typename F>
+inline constexpr void resize_and_fill(C &c, std::size_t n, F fill)
+{
+    if constexpr (resize_and_overwrite_container<C>)
+    {
+        c.resize_and_overwrite(n, [&fill](auto ptr, auto) { return fill(ptr); });
+    }
+    else
+    {
+        c.resize(n);
+        c.resize(fill(c.data()));
+    }
+}
+
+// size c to its size plus n, let fill write the new elements through a raw
+// pointer and shrink c to the count fill returns
+template <typename C, typename F>
+inline constexpr void append_and_fill(C &c, std::size_t n, F fill)
+{
+    auto old = c.size();
+
+    if constexpr (resize_and_overwrite_container<C>)
+    {
+        c.resize_and_overwrite(old + n, [old, &fill](auto ptr, auto) { return old + fill(ptr + old); });
+    }
+    else
+    {
+        c.resize(old + n);
+        c.resize(old + fill(c.data() + old));
+    }
+}
+
+template <typename Out>
+struct back_inserter_container
+{
+};
+
+template <typename C>
+struct back_inserter_container<std::back_insert_iterator<C>>
+{
+    using type = C;
+};
+
+// a std::back_insert_iterator to a container of narrow chars with contiguous
+// storage, such as std::string and std::vector<char>, which the encoder and
+// decoder grow once and write through a raw pointer
+template <typename Out>
+concept contiguous_back_inserter = requires(typename back_inserter_container<Out>::type &c) {
+    requires narrow_contiguous_iterator<decltype(c.data())>;
+    c.resize(std::size_t{});
+};
+
+// NB: the container of a std::back_insert_iterator is a protected member
+template <typename C>
+inline constexpr C &get_container(std::back_insert_iterator<C> const &it) noexcept
+{
+    struct access : std::back_insert_iterator<C>
+    {
+        static constexpr C *get(std::back_insert_iterator<C> const &it) noexcept
+        {
+            return it.*&access::container;
+        }
+    };
+
+    return *access::get(it);
+}
+
 using buf_ref = unsigned char (&)[4];
 using sig_ref = unsigned char &;
 
@@ -55,6 +217,7 @@ namespace encode_impl
 {
 // forward declaration for friend
 struct rfc4648_encode_fn;
+struct rfc4648_encode_wrap_fn;
 } // namespace encode_impl
 
 namespace decode_impl
@@ -72,10 +235,27 @@ class rfc4648_context
     // 0 - 8 for base32 decode, only buf_[0] is significant
     // 0 - 2 for base16 decode, only buf_[0] is significant
     alignas(int) unsigned char sig_{};
-    alignas(int) unsigned char buf_[4];
+    alignas(int) unsigned char buf_[4]{};
+    // column of rfc4648_encode_wrap
+    std::size_t col_{};
 
     friend encode_impl::rfc4648_encode_fn;
+    friend encode_impl::rfc4648_encode_wrap_fn;
     friend decode_impl::rfc4648_decode_fn;
 };
 
+// length of the encoding of n bytes
+template <rfc4648_kind Kind = rfc4648_kind::base64, bool Padding = true>
+inline constexpr std::size_t rfc4648_encoded_size(std::size_t n) noexcept
+{
+    return detail::encoded_size<Kind, Padding>(n);
+}
+
+// upper bound of the bytes decoded from n chars
+template <rfc4648_kind Kind = rfc4648_kind::base64>
+inline constexpr std::size_t rfc4648_max_decoded_size(std::size_t n) noexcept
+{
+    return detail::decoded_size<Kind>(n);
+}
+
 } // namespace bizwen
\ No newline at end of file
@@ -1,11 +1,20 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <bit>
 #include <concepts>
+#include <cstdint>
 #include <cstring>
 #include <iterator>
+#include <optional>
+#include <ranges>
+#include <span>
 #include <utility>
 
 #include "./common.hpp"
+#include "./parallel.hpp"
+#include "./simd.hpp"
 
 namespace bizwen
 {
@@ -31,7 +40,7 @@ static inline constexpr unsigned char base64[] = {
 static inline constexpr unsigned char base64_url[] = {
     0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
     0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x62, 0xFF, 0xFF, 52,   53,   54,   55,   56,   57,   58,   59,   60,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 62,   0xFF, 0xFF, 52,   53,   54,   55,   56,   57,   58,   59,   60,
     61,   0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0,    1,    2,    3,    4,    5,    6,    7,    8,    9,    10,
     11,   12,   13,   14,   15,   16,   17,   18,   19,   20,   21,   22,   23,   24,   25,   0xFF, 0xFF, 0xFF, 0xFF,
     63,   0xFF, 26,   27,   28,   29,   30,   31,   32,   33,   34,   35,   36,   37,   38,   39,   40,   41,   42,
@@ -125,7 +134,7 @@ static inline constexpr unsigned char base32_crockford_lower[] = {
     9,    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
     0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
     0xFF, 0xFF, 10,   11,   12,   13,   14,   15,   16,   17,   0xFF, 18,   19,   0xFF, 20,   21,   0xFF, 22,   23,
-    24,   25,   26,   0xFF, 27,   28,   29,   30,   31,   32,   0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    24,   25,   26,   0xFF, 27,   28,   29,   30,   31,   0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
     0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
     0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
     0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
@@ -219,6 +228,12 @@ inline constexpr unsigned char decode_single(unsigned char const *table, T t) no
     return table[static_cast<unsigned char>(t)];
 }
 
+template <typename T>
+inline constexpr bool is_space(T t) noexcept
+{
+    return t == ' ' || (t >= '\t' && t <= '\r');
+}
+
 struct decode_status_b64_b32
 {
     // base64
@@ -239,7 +254,7 @@ struct decode_status_b64_b32
     alignas(int) unsigned char buf_;
 
     template <typename C, typename Out>
-    bool write_b64(unsigned char const *table, C c, Out &first)
+    constexpr bool write_b64(unsigned char const *table, C c, Out &first)
     {
         auto res = decode_single(table, c);
 
@@ -280,7 +295,7 @@ struct decode_status_b64_b32
     }
 
     template <typename C, typename Out>
-    bool write_b32(unsigned char const *table, C c, Out &first)
+    constexpr bool write_b32(unsigned char const *table, C c, Out &first)
     {
         auto res = decode_single(table, c);
 
@@ -339,305 +354,1770 @@ struct decode_status_b64_b32
 
         return true;
     }
-
-    template <typename Out>
-    void write(unsigned char const *table, Out &first)
-    {
-        if (sig_)
-        {
-            *first = buf_;
-            ++first;
-            sig_ = 0;
-        }
-    }
 };
 
-template <typename In, typename Out>
-inline constexpr In decode_impl_b32(unsigned char const *table, In begin, In end, Out &first)
+// bit h of lut[l] is set if the char h << 4 | l is in the table, the vector
+// kernels validate a char by testing lut[c & 15] & (1 << (c >> 4))
+template <rfc4648_kind Kind>
+inline consteval auto get_nibble_lut() noexcept
 {
-    static_assert(std::is_pointer_v<In>);
-
-    decode_status_b64_b32 status{};
+    auto table = get_table<Kind>();
+    std::array<unsigned char, 16> lut{};
 
-    for (; begin != end; ++begin)
+    for (std::size_t c{}; c != 128; ++c)
     {
-        if (!status.write_b64(table, *begin, first))
-            break;
+        if (valid_stage2(table[c]))
+            lut[c & 15] |= static_cast<unsigned char>(1u << (c >> 4));
     }
 
-    status.write(table, first);
+    return lut;
+}
 
-    return begin;
+template <rfc4648_kind Kind>
+inline consteval unsigned char get_char(unsigned char value) noexcept
+{
+    auto table = get_table<Kind>();
+    unsigned char c{};
+
+    while (table[c] != value)
+        ++c;
+
+    return c;
 }
 
-template <typename In, typename Out>
-inline constexpr In decode_impl_b64(unsigned char const *table, In begin, In end, Out &first)
+#if defined(BIZWEN_RFC4648_HAS_SIMD)
+// translate 16 base64 chars to their values, returns false if any is invalid
+template <rfc4648_kind Kind>
+BIZWEN_RFC4648_TARGET_SSSE3 inline bool decode_impl_b64_translate_ssse3(__m128i &in) noexcept
 {
-    static_assert(std::is_pointer_v<In>);
+    static constexpr auto lut = get_nibble_lut<Kind>();
+    static constexpr auto c62 = get_char<Kind>(62);
+    static constexpr auto c63 = get_char<Kind>(63);
 
-    decode_status_b64_b32 status{};
+    auto const lut_lo = _mm_loadu_si128(reinterpret_cast<__m128i const *>(lut.data()));
+    auto const lut_hi = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0);
+    // '0' - '9', 'A' - 'Z', 'a' - 'z' by high nibble, c62 and c63 are patched
+    auto const lut_roll = _mm_setr_epi8(0, 0, 0, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
 
-    for (; begin != end; ++begin)
+    auto hi_nibbles = _mm_and_si128(_mm_srli_epi16(in, 4), _mm_set1_epi8(15));
+    auto lo_nibbles = _mm_and_si128(in, _mm_set1_epi8(15));
+    auto valid = _mm_and_si128(_mm_shuffle_epi8(lut_lo, lo_nibbles), _mm_shuffle_epi8(lut_hi, hi_nibbles));
+
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(valid, _mm_setzero_si128())))
+        return false;
+
+    auto eq62 = _mm_cmpeq_epi8(in, _mm_set1_epi8(static_cast<char>(c62)));
+    auto eq63 = _mm_cmpeq_epi8(in, _mm_set1_epi8(static_cast<char>(c63)));
+    auto roll = _mm_shuffle_epi8(lut_roll, hi_nibbles);
+    roll = _mm_or_si128(_mm_andnot_si128(eq62, roll), _mm_and_si128(eq62, _mm_set1_epi8(static_cast<char>(62 - c62))));
+    roll = _mm_or_si128(_mm_andnot_si128(eq63, roll), _mm_and_si128(eq63, _mm_set1_epi8(static_cast<char>(63 - c63))));
+
+    in = _mm_add_epi8(in, roll);
+
+    return true;
+}
+
+// 16 chars -> 12 bytes per iteration, returns the number of chars consumed
+// stops before the first block containing an invalid char
+template <rfc4648_kind Kind>
+BIZWEN_RFC4648_TARGET_SSSE3 inline std::size_t decode_impl_b64_ssse3(unsigned char const *begin, std::size_t len,
+                                                                     unsigned char *first) noexcept
+{
+    std::size_t i{};
+
+    for (; len - i >= 16; i += 16, first += 12)
     {
-        if (!status.write_b64(table, *begin, first))
+        auto in = _mm_loadu_si128(reinterpret_cast<__m128i const *>(begin + i));
+
+        if (!decode_impl_b64_translate_ssse3<Kind>(in))
             break;
-    }
 
-    status.write(table, first);
+        auto merged = _mm_maddubs_epi16(in, _mm_set1_epi32(0x01400140));
+        merged = _mm_madd_epi16(merged, _mm_set1_epi32(0x00011000));
+        auto out = _mm_shuffle_epi8(merged, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
 
-    return begin;
+        auto tail = _mm_cvtsi128_si32(_mm_srli_si128(out, 8));
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(first), out);
+        std::memcpy(first + 8, &tail, 4);
+    }
+
+    return i;
 }
 
-template <typename In, typename Out>
-inline constexpr In decode_impl_b64_ctx(unsigned char const *table, detail::sig_ref sig, detail::buf_ref buf, In begin, In end,
-                                        Out &first)
+// translate 32 base64 chars to their values, returns false if any is invalid
+template <rfc4648_kind Kind>
+BIZWEN_RFC4648_TARGET_AVX2 inline bool decode_impl_b64_translate_avx2(__m256i &in) noexcept
 {
-    static_assert(std::is_pointer_v<In>);
+    static constexpr auto lut = get_nibble_lut<Kind>();
+    static constexpr auto c62 = get_char<Kind>(62);
+    static constexpr auto c63 = get_char<Kind>(63);
 
-    decode_status_b64_b32 status{sig, buf[0]};
+    auto const lut_lo = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<__m128i const *>(lut.data())));
+    auto const lut_hi = _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 4, 8, 16, 32, 64,
+                                         -128, 0, 0, 0, 0, 0, 0, 0, 0);
+    auto const lut_roll = _mm256_setr_epi8(0, 0, 0, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 4, -65,
+                                           -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
 
-    for (; begin != end; ++begin)
+    auto hi_nibbles = _mm256_and_si256(_mm256_srli_epi16(in, 4), _mm256_set1_epi8(15));
+    auto lo_nibbles = _mm256_and_si256(in, _mm256_set1_epi8(15));
+    auto valid =
+        _mm256_and_si256(_mm256_shuffle_epi8(lut_lo, lo_nibbles), _mm256_shuffle_epi8(lut_hi, hi_nibbles));
+
+    if (_mm256_movemask_epi8(_mm256_cmpeq_epi8(valid, _mm256_setzero_si256())))
+        return false;
+
+    auto roll = _mm256_shuffle_epi8(lut_roll, hi_nibbles);
+    roll = _mm256_blendv_epi8(roll, _mm256_set1_epi8(static_cast<char>(62 - c62)),
+                              _mm256_cmpeq_epi8(in, _mm256_set1_epi8(static_cast<char>(c62))));
+    roll = _mm256_blendv_epi8(roll, _mm256_set1_epi8(static_cast<char>(63 - c63)),
+                              _mm256_cmpeq_epi8(in, _mm256_set1_epi8(static_cast<char>(c63))));
+
+    in = _mm256_add_epi8(in, roll);
+
+    return true;
+}
+
+// 32 chars -> 24 bytes per iteration, returns the number of chars consumed
+// stops before the first block containing an invalid char
+template <rfc4648_kind Kind>
+BIZWEN_RFC4648_TARGET_AVX2 inline std::size_t decode_impl_b64_avx2(unsigned char const *begin, std::size_t len,
+                                                                   unsigned char *first) noexcept
+{
+    std::size_t i{};
+
+    for (; len - i >= 32; i += 32, first += 24)
     {
-        if (!status.write_b64(table, *begin, first))
+        auto in = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(begin + i));
+
+        if (!decode_impl_b64_translate_avx2<Kind>(in))
             break;
+
+        auto merged = _mm256_maddubs_epi16(in, _mm256_set1_epi32(0x01400140));
+        merged = _mm256_madd_epi16(merged, _mm256_set1_epi32(0x00011000));
+        merged = _mm256_shuffle_epi8(merged, _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                                                              2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+        auto out = _mm256_permutevar8x32_epi32(merged, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(first), _mm256_castsi256_si128(out));
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(first + 16), _mm256_extracti128_si256(out, 1));
     }
 
-    sig = status.sig_;
-    buf[0] = status.buf_;
+    return i;
+}
 
-    return begin;
+// byte 3 * i + j of the output is byte 4 * i + 2 - j of the packed lanes
+inline consteval auto get_b64_pack_lut() noexcept
+{
+    std::array<unsigned char, 64> lut{};
+
+    for (std::size_t i{}; i != 16; ++i)
+    {
+        lut[i * 3] = static_cast<unsigned char>(i * 4 + 2);
+        lut[i * 3 + 1] = static_cast<unsigned char>(i * 4 + 1);
+        lut[i * 3 + 2] = static_cast<unsigned char>(i * 4);
+    }
+
+    return lut;
 }
 
-template <typename In, typename Out>
-inline constexpr In decode_impl_b32_ctx(unsigned char const *table, detail::sig_ref sig, detail::buf_ref buf, In begin, In end,
-                                        Out &first)
+// 64 chars -> 48 bytes per iteration, the tail and the block containing the
+// first invalid char are decoded with masked loads and stores, returns the
+// number of chars consumed, n * 3 / 4 bytes are written
+template <rfc4648_kind Kind>
+BIZWEN_RFC4648_TARGET_AVX512VBMI inline std::size_t decode_impl_b64_avx512vbmi(unsigned char const *begin,
+                                                                               std::size_t len,
+                                                                               unsigned char *first) noexcept
 {
-    static_assert(std::is_pointer_v<In>);
+    static constexpr auto pack = get_b64_pack_lut();
 
-    decode_status_b64_b32 status{sig, buf[0]};
+    // the table maps invalid chars to 0xFF, chars above 127 are checked separately
+    auto const lookup_lo = _mm512_loadu_si512(get_table<Kind>());
+    auto const lookup_hi = _mm512_loadu_si512(get_table<Kind>() + 64);
+    auto const pack_lut = _mm512_loadu_si512(pack.data());
 
-    for (; begin != end; ++begin)
+    std::size_t i{};
+
+    while (i != len)
     {
-        if (!status.write_b32(table, *begin, first))
+        auto rest = len - i;
+        auto load = detail::mask_first_n(rest);
+        auto in = _mm512_maskz_loadu_epi8(load, begin + i);
+        auto values = _mm512_permutex2var_epi8(lookup_lo, in, lookup_hi);
+        auto invalid = _mm512_movepi8_mask(_mm512_or_si512(values, in)) & load;
+
+        std::size_t n = invalid ? std::countr_zero(invalid) : (rest < 64 ? rest : 64);
+
+        if (n != 64)
+            values = _mm512_maskz_mov_epi8(detail::mask_first_n(n), values);
+
+        auto merged = _mm512_maddubs_epi16(values, _mm512_set1_epi32(0x01400140));
+        merged = _mm512_madd_epi16(merged, _mm512_set1_epi32(0x00011000));
+        auto out = _mm512_permutexvar_epi8(pack_lut, merged);
+
+        _mm512_mask_storeu_epi8(first, detail::mask_first_n(n * 3 / 4), out);
+
+        i += n;
+        first += n * 3 / 4;
+
+        if (n != 64)
             break;
     }
 
-    sig = status.sig_;
-    buf[0] = status.buf_;
-
-    return begin;
+    return i;
 }
 
-template <typename In, typename Out>
-inline constexpr void decode_impl_b64_b32_ctx(unsigned char const *table, detail::sig_ref sig, detail::buf_ref buf, Out &first)
+// lut[h - 3][l] is the value of the char h << 4 | l, base32 alphabets only
+// use the high nibbles 3 - 7
+template <rfc4648_kind Kind>
+inline consteval auto get_b32_value_lut() noexcept
 {
-    static_assert(std::is_pointer_v<In>);
-
-    decode_status_b64_b32 status{sig, buf[0]};
+    auto table = get_table<Kind>();
+    std::array<std::array<unsigned char, 16>, 5> lut{};
 
-    status.write(table, first);
+    for (std::size_t c{}; c != 128; ++c)
+    {
+        if (c >= 0x30 && valid_stage2(table[c]))
+            lut[(c >> 4) - 3][c & 15] = table[c];
+    }
 
-    sig = 0;
+    return lut;
 }
 
-template <typename In, typename Out>
-inline constexpr In decode_impl_b16(unsigned char const *table, In begin, In end, Out &first)
+// 32 chars -> 20 bytes per iteration, returns the number of chars consumed
+// stops before the first block containing an invalid char
+template <rfc4648_kind Kind>
+BIZWEN_RFC4648_TARGET_AVX2 inline std::size_t decode_impl_b32_avx2(unsigned char const *begin, std::size_t len,
+                                                                   unsigned char *first) noexcept
 {
-    static_assert(std::is_pointer_v<In>);
+    static constexpr auto lut = get_nibble_lut<Kind>();
+    static constexpr auto values_lut = get_b32_value_lut<Kind>();
 
-    unsigned char sig{};
-    unsigned char buf;
+    auto const lut_lo = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<__m128i const *>(lut.data())));
+    auto const lut_hi = _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 4, 8, 16, 32, 64,
+                                         -128, 0, 0, 0, 0, 0, 0, 0, 0);
+    // 8 chars of each 64-bit lane -> 5 bytes in big endian
+    auto const pack = _mm256_setr_epi8(4, 3, 2, 1, 0, 12, 11, 10, 9, 8, -1, -1, -1, -1, -1, -1, 4, 3, 2, 1, 0, 12, 11,
+                                       10, 9, 8, -1, -1, -1, -1, -1, -1);
 
-    for (; begin != end; ++begin)
+    __m256i value_luts[5];
+
+    for (std::size_t h{}; h != 5; ++h)
+        value_luts[h] =
+            _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<__m128i const *>(values_lut[h].data())));
+
+    std::size_t i{};
+
+    for (; len - i >= 32; i += 32, first += 20)
     {
-        auto c = *begin;
-        auto res = decode_single(table, c);
+        auto in = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(begin + i));
+        auto hi_nibbles = _mm256_and_si256(_mm256_srli_epi16(in, 4), _mm256_set1_epi8(15));
+        auto lo_nibbles = _mm256_and_si256(in, _mm256_set1_epi8(15));
+        auto valid =
+            _mm256_and_si256(_mm256_shuffle_epi8(lut_lo, lo_nibbles), _mm256_shuffle_epi8(lut_hi, hi_nibbles));
 
-        if (!is_valid(c, res))
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi8(valid, _mm256_setzero_si256())))
             break;
 
-        ++sig;
+        auto values = _mm256_setzero_si256();
 
-        if (sig == 1)
-        {
-            buf = res << 4;
-        }
-        else if (sig == 2)
+        for (std::size_t h{}; h != 5; ++h)
         {
-            *first = buf | res;
-            ++first;
-            sig = 0;
+            auto select = _mm256_cmpeq_epi8(hi_nibbles, _mm256_set1_epi8(static_cast<char>(h + 3)));
+            values = _mm256_or_si256(values, _mm256_and_si256(select, _mm256_shuffle_epi8(value_luts[h], lo_nibbles)));
         }
-    }
 
-    if (sig)
-    {
-        *first = buf;
-        ++first;
+        // 5 + 5 -> 10 bits, 10 + 10 -> 20 bits, 20 + 20 -> 40 bits
+        auto merged = _mm256_maddubs_epi16(values, _mm256_set1_epi16(0x0120));
+        merged = _mm256_madd_epi16(merged, _mm256_set1_epi32(0x00010400));
+        merged = _mm256_or_si256(_mm256_slli_epi64(_mm256_and_si256(merged, _mm256_set1_epi64x(0xFFFFFFFF)), 20),
+                                 _mm256_srli_epi64(merged, 32));
+        auto out = _mm256_shuffle_epi8(merged, pack);
+        auto out_hi = _mm256_extracti128_si256(out, 1);
+        auto last = static_cast<unsigned short>(_mm_extract_epi16(out_hi, 4));
+
+        // NB: the garbage of the first store is overwritten by the second
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(first), _mm256_castsi256_si128(out));
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(first + 10), out_hi);
+        std::memcpy(first + 18, &last, 2);
     }
 
-    return begin;
+    return i;
 }
 
-template <typename In, typename Out>
-inline constexpr In decode_impl_b16_ctx(unsigned char const *table, detail::sig_ref sig, detail::buf_ref buf, In begin, In end,
-                                        Out &first)
+// '0' - '9', 'A' - 'F' and 'a' - 'f' by high nibble
+inline constexpr char b16_roll[16] = {0, 0, 0, -48, -55, 0, -87, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+
+// 16 chars -> 8 bytes per iteration, returns the number of chars consumed
+// stops before the first block containing an invalid char
+template <rfc4648_kind Kind>
+BIZWEN_RFC4648_TARGET_SSSE3 inline std::size_t decode_impl_b16_ssse3(unsigned char const *begin, std::size_t len,
+                                                                     unsigned char *first) noexcept
 {
-    static_assert(std::is_pointer_v<In>);
+    static constexpr auto lut = get_nibble_lut<Kind>();
 
-    for (; begin != end; ++begin)
+    auto const lut_lo = _mm_loadu_si128(reinterpret_cast<__m128i const *>(lut.data()));
+    auto const lut_hi = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0);
+    auto const lut_roll = _mm_loadu_si128(reinterpret_cast<__m128i const *>(b16_roll));
+
+    std::size_t i{};
+
+    for (; len - i >= 16; i += 16, first += 8)
     {
-        auto c = *begin;
-        auto res = decode_single(table, c);
+        auto in = _mm_loadu_si128(reinterpret_cast<__m128i const *>(begin + i));
+        auto hi_nibbles = _mm_and_si128(_mm_srli_epi16(in, 4), _mm_set1_epi8(15));
+        auto lo_nibbles = _mm_and_si128(in, _mm_set1_epi8(15));
+        auto valid = _mm_and_si128(_mm_shuffle_epi8(lut_lo, lo_nibbles), _mm_shuffle_epi8(lut_hi, hi_nibbles));
 
-        if (!is_valid(c, res))
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(valid, _mm_setzero_si128())))
             break;
 
-        ++sig;
+        auto values = _mm_add_epi8(in, _mm_shuffle_epi8(lut_roll, hi_nibbles));
+        auto merged = _mm_maddubs_epi16(values, _mm_set1_epi16(0x0110));
 
-        if (sig == 1)
-        {
-            buf[0] = res << 4;
-            sig = 1;
-        }
-        else if (sig == 2)
-        {
-            *first = buf[0] | res;
-            ++first;
-            sig = 0;
-        }
-        else
-        {
-            std::unreachable();
-        }
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(first), _mm_packus_epi16(merged, merged));
     }
 
-    return begin;
+    return i;
 }
 
-template <typename Out>
-inline constexpr void decode_impl_b16_ctx(unsigned char const *table, detail::sig_ref sig, detail::buf_ref buf, Out &first)
+// 32 chars -> 16 bytes per iteration, returns the number of chars consumed
+// stops before the first block containing an invalid char
+template <rfc4648_kind Kind>
+BIZWEN_RFC4648_TARGET_AVX2 inline std::size_t decode_impl_b16_avx2(unsigned char const *begin, std::size_t len,
+                                                                   unsigned char *first) noexcept
 {
-    if (sig)
+    static constexpr auto lut = get_nibble_lut<Kind>();
+
+    auto const lut_lo = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<__m128i const *>(lut.data())));
+    auto const lut_hi = _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 4, 8, 16, 32, 64,
+                                         -128, 0, 0, 0, 0, 0, 0, 0, 0);
+    auto const lut_roll = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<__m128i const *>(b16_roll)));
+
+    std::size_t i{};
+
+    for (; len - i >= 32; i += 32, first += 16)
     {
-        *first = buf[0];
-        ++first;
-        sig = 0;
+        auto in = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(begin + i));
+        auto hi_nibbles = _mm256_and_si256(_mm256_srli_epi16(in, 4), _mm256_set1_epi8(15));
+        auto lo_nibbles = _mm256_and_si256(in, _mm256_set1_epi8(15));
+        auto valid =
+            _mm256_and_si256(_mm256_shuffle_epi8(lut_lo, lo_nibbles), _mm256_shuffle_epi8(lut_hi, hi_nibbles));
+
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi8(valid, _mm256_setzero_si256())))
+            break;
+
+        auto values = _mm256_add_epi8(in, _mm256_shuffle_epi8(lut_roll, hi_nibbles));
+        auto merged = _mm256_maddubs_epi16(values, _mm256_set1_epi16(0x0110));
+        // NB: pack works within 128-bit lanes
+        auto out = _mm256_permute4x64_epi64(_mm256_packus_epi16(merged, merged), 0x08);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(first), _mm256_castsi256_si128(out));
     }
+
+    return i;
 }
 
-template <typename End, typename Out>
-struct rfc4648_decode_result
+// for each 8-bit mask of space chars, the indices of the other chars packed
+// into the low bytes
+inline consteval auto get_compact_shuffle() noexcept
 {
-    End end;
-    Out out;
-};
+    std::array<unsigned long long, 256> shuffle{};
 
-struct rfc4648_decode_fn
-{
-    template <rfc4648_kind Kind = rfc4648_kind::base64, typename In, typename Out>
-#if defined(__cpp_static_call_operator) && __cpp_static_call_operator >= 202207L
-    static
-#endif
-        inline constexpr rfc4648_decode_result<In, Out>
-        operator()(In begin, In end, Out first)
-#if !defined(__cpp_static_call_operator) || __cpp_static_call_operator < 202207L
-            const
-#endif
+    for (std::size_t m{}; m != 256; ++m)
     {
-        using in_char = std::iterator_traits<In>::value_type;
+        std::size_t n{};
 
-        static_assert(std::contiguous_iterator<In>);
-        static_assert(std::is_same_v<in_char, char> || std::is_same_v<in_char, wchar_t> ||
-                      std::is_same_v<in_char, char8_t> || std::is_same_v<in_char, char16_t> ||
-                      std::is_same_v<in_char, char32_t>);
+        for (std::size_t i{}; i != 8; ++i)
+        {
+            if (!(m >> i & 1))
+                shuffle[m] |= static_cast<unsigned long long>(i) << (n++ * 8);
+        }
+    }
 
-        auto begin_ptr = detail::to_address_const(begin);
-        auto end_ptr = detail::to_address_const(end);
+    return shuffle;
+}
 
-        decltype(begin_ptr) last_ptr = {};
+inline constexpr auto compact_shuffle = get_compact_shuffle();
 
-        if constexpr (detail::get_family<Kind>() == rfc4648_kind::base64)
-            last_ptr = decode_impl::decode_impl_b64(decode_impl::get_table<Kind>(), begin_ptr, end_ptr, first);
-        if constexpr (detail::get_family<Kind>() == rfc4648_kind::base32)
-            last_ptr = decode_impl::decode_impl_b32(decode_impl::get_table<Kind>(), begin_ptr, end_ptr, first);
-        ;
-        if constexpr (detail::get_family<Kind>() == rfc4648_kind::base16)
-            last_ptr = decode_impl::decode_impl_b16(decode_impl::get_table<Kind>(), begin_ptr, end_ptr, first);
-        ;
+// copies the chars that are not ASCII space to out 16 at a time, stops when
+// fewer than 16 chars or 16 free slots remain, returns {consumed, written}
+BIZWEN_RFC4648_TARGET_SSSE3 inline std::pair<std::size_t, std::size_t> compact_space_ssse3(unsigned char const *in,
+                                                                                          std::size_t len,
+                                                                                          unsigned char *out,
+                                                                                          std::size_t cap) noexcept
+{
+    auto const space = _mm_set1_epi8(' ');
+    auto const tab = _mm_set1_epi8('\t');
+    auto const four = _mm_set1_epi8(4);
 
-        return {begin + (last_ptr - begin_ptr), std::move(first)};
-    }
+    std::size_t i{};
+    std::size_t n{};
 
-    template <rfc4648_kind Kind = rfc4648_kind::base64, typename R, typename Out>
-#if defined(__cpp_static_call_operator) && __cpp_static_call_operator >= 202207L
-    static
-#endif
-        inline constexpr auto
-        operator()(R &&r, Out first)
-#if !defined(__cpp_static_call_operator) || __cpp_static_call_operator < 202207L
-            const
-#endif
+    for (; len - i >= 16 && cap - n >= 16; i += 16)
     {
-        return operator()<Kind>(std::ranges::begin(r), std::ranges::end(r), first);
+        auto v = _mm_loadu_si128(reinterpret_cast<__m128i const *>(in + i));
+        // ' ' or '\t' - '\r'
+        auto t = _mm_sub_epi8(v, tab);
+        auto spaces = _mm_or_si128(_mm_cmpeq_epi8(v, space), _mm_cmpeq_epi8(_mm_min_epu8(t, four), t));
+        auto mask = static_cast<unsigned int>(_mm_movemask_epi8(spaces));
+
+        if (!mask)
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + n), v);
+            n += 16;
+
+            continue;
+        }
+
+        auto lo = mask & 0xFF;
+        auto hi = mask >> 8;
+        auto ctl = _mm_set_epi64x(static_cast<long long>(compact_shuffle[hi] + 0x0808080808080808),
+                                  static_cast<long long>(compact_shuffle[lo]));
+        auto packed = _mm_shuffle_epi8(v, ctl);
+
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(out + n), packed);
+        n += 8 - std::popcount(lo);
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(out + n), _mm_srli_si128(packed, 8));
+        n += 8 - std::popcount(hi);
     }
 
-    template <rfc4648_kind Kind = rfc4648_kind::base64, typename In, typename Out>
-#if defined(__cpp_static_call_operator) && __cpp_static_call_operator >= 202207L
-    static
-#endif
-        inline constexpr rfc4648_decode_result<In, Out>
-        operator()(rfc4648_context &ctx, In begin, In end, Out first)
-#if !defined(__cpp_static_call_operator) || __cpp_static_call_operator < 202207L
-            const
-#endif
-    {
-        using in_char = std::iterator_traits<In>::value_type;
+    return {i, n};
+}
 
-        static_assert(std::contiguous_iterator<In>);
-        static_assert(std::is_same_v<in_char, char> || std::is_same_v<in_char, wchar_t> ||
-                      std::is_same_v<in_char, char8_t> || std::is_same_v<in_char, char16_t> ||
-                      std::is_same_v<in_char, char32_t>);
+// same as compact_space_ssse3, 32 chars at a time
+BIZWEN_RFC4648_TARGET_AVX2 inline std::pair<std::size_t, std::size_t> compact_space_avx2(unsigned char const *in,
+                                                                                        std::size_t len,
+                                                                                        unsigned char *out,
+                                                                                        std::size_t cap) noexcept
+{
+    auto const space = _mm256_set1_epi8(' ');
+    auto const tab = _mm256_set1_epi8('\t');
+    auto const four = _mm256_set1_epi8(4);
 
-        auto begin_ptr = detail::to_address_const(begin);
-        auto end_ptr = detail::to_address_const(end);
+    std::size_t i{};
+    std::size_t n{};
 
-        decltype(begin_ptr) last_ptr = {};
+    for (; len - i >= 32 && cap - n >= 32; i += 32)
+    {
+        auto v = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(in + i));
+        auto t = _mm256_sub_epi8(v, tab);
+        auto spaces = _mm256_or_si256(_mm256_cmpeq_epi8(v, space), _mm256_cmpeq_epi8(_mm256_min_epu8(t, four), t));
+        auto mask = static_cast<unsigned int>(_mm256_movemask_epi8(spaces));
 
-        if constexpr (detail::get_family<Kind>() == rfc4648_kind::base64)
-            last_ptr = decode_impl::decode_impl_b64_ctx(decode_impl::get_table<Kind>(), ctx.sig_, ctx.buf_, begin_ptr,
-                                                        end_ptr, first);
-        if constexpr (detail::get_family<Kind>() == rfc4648_kind::base32)
-            last_ptr = decode_impl::decode_impl_b32_ctx(decode_impl::get_table<Kind>(), ctx.sig_, ctx.buf_, begin_ptr,
-                                                        end_ptr, first);
-        ;
-        if constexpr (detail::get_family<Kind>() == rfc4648_kind::base16)
-            last_ptr = decode_impl::decode_impl_b16_ctx(decode_impl::get_table<Kind>(), ctx.sig_, ctx.buf_, begin_ptr,
-                                                        end_ptr, first);
-        ;
+        if (!mask)
+        {
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + n), v);
+            n += 32;
 
-        return {begin + (last_ptr - begin_ptr), std::move(first)};
+            continue;
+        }
+
+        // the shuffle only moves bytes within 128-bit lanes
+        auto ctl = _mm256_set_epi64x(static_cast<long long>(compact_shuffle[mask >> 24] + 0x0808080808080808),
+                                     static_cast<long long>(compact_shuffle[mask >> 16 & 0xFF]),
+                                     static_cast<long long>(compact_shuffle[mask >> 8 & 0xFF] + 0x0808080808080808),
+                                     static_cast<long long>(compact_shuffle[mask & 0xFF]));
+        auto packed = _mm256_shuffle_epi8(v, ctl);
+        auto lo = _mm256_castsi256_si128(packed);
+        auto hi = _mm256_extracti128_si256(packed, 1);
+
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(out + n), lo);
+        n += 8 - std::popcount(mask & 0xFF);
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(out + n), _mm_srli_si128(lo, 8));
+        n += 8 - std::popcount(mask >> 8 & 0xFF);
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(out + n), hi);
+        n += 8 - std::popcount(mask >> 16 & 0xFF);
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(out + n), _mm_srli_si128(hi, 8));
+        n += 8 - std::popcount(mask >> 24);
     }
 
-    template <rfc4648_kind Kind = rfc4648_kind::base64, typename R, typename Out>
+    return {i, n};
+}
+
+// the byte of a code unit, units above 0xFF become 0 or 0xFF like the
+// saturating packs below, neither is in any table
+template <typename C>
+inline constexpr unsigned char narrow_unit(C c) noexcept
+{
+    using unsigned_type = std::make_unsigned_t<C>;
+
+    if (static_cast<unsigned_type>(c) > 0xFF)
+        return static_cast<unsigned_type>(c) >> (sizeof(C) * 8 - 1) ? 0 : 0xFF;
+
+    return static_cast<unsigned char>(c);
+}
+
+// narrow len 16 or 32-bit code units to bytes, 16 at a time
+template <typename C>
+BIZWEN_RFC4648_TARGET_SSSE3 inline void narrow_ssse3(C const *in, std::size_t len, unsigned char *out) noexcept
+{
+    std::size_t i{};
+
+    for (; len - i >= 16; i += 16)
+    {
+        auto p = reinterpret_cast<__m128i const *>(in + i);
+        __m128i lo, hi;
+
+        if constexpr (sizeof(C) == 2)
+        {
+            lo = _mm_loadu_si128(p);
+            hi = _mm_loadu_si128(p + 1);
+        }
+        else
+        {
+            // NB: signed saturation keeps units above 0x7FFF out of the byte range
+            lo = _mm_packs_epi32(_mm_loadu_si128(p), _mm_loadu_si128(p + 1));
+            hi = _mm_packs_epi32(_mm_loadu_si128(p + 2), _mm_loadu_si128(p + 3));
+        }
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), _mm_packus_epi16(lo, hi));
+    }
+
+    for (; i != len; ++i)
+        out[i] = narrow_unit(in[i]);
+}
+
+// same as narrow_ssse3, 32 at a time
+template <typename C>
+BIZWEN_RFC4648_TARGET_AVX2 inline void narrow_avx2(C const *in, std::size_t len, unsigned char *out) noexcept
+{
+    std::size_t i{};
+
+    for (; len - i >= 32; i += 32)
+    {
+        auto p = reinterpret_cast<__m256i const *>(in + i);
+        __m256i packed;
+
+        // NB: pack works within 128-bit lanes
+        if constexpr (sizeof(C) == 2)
+        {
+            packed = _mm256_packus_epi16(_mm256_loadu_si256(p), _mm256_loadu_si256(p + 1));
+            packed = _mm256_permute4x64_epi64(packed, 0xD8);
+        }
+        else
+        {
+            auto lo = _mm256_packs_epi32(_mm256_loadu_si256(p), _mm256_loadu_si256(p + 1));
+            auto hi = _mm256_packs_epi32(_mm256_loadu_si256(p + 2), _mm256_loadu_si256(p + 3));
+
+            packed = _mm256_packus_epi16(lo, hi);
+            packed = _mm256_permutevar8x32_epi32(packed, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+        }
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), packed);
+    }
+
+    for (; i != len; ++i)
+        out[i] = narrow_unit(in[i]);
+}
+
+// wide input is narrowed in blocks of this many code units, which stay in L1
+// between the narrowing and the decode kernel
+inline constexpr std::size_t narrow_block_size = 2048;
+
+using decode_kernel = std::size_t (*)(unsigned char const *, std::size_t, unsigned char *) noexcept;
+
+// resolved once per kind, nullptr if there is no kernel for the CPU
+// the kernels return the number of chars consumed, decoded_size() of it is written
+template <rfc4648_kind Kind>
+inline decode_kernel get_decode_kernel() noexcept
+{
+    static decode_kernel const kernel = []() noexcept -> decode_kernel {
+        auto level = detail::get_simd_level();
+
+        if constexpr (detail::get_family<Kind>() == rfc4648_kind::base64)
+        {
+            if (level >= detail::simd_level::avx512vbmi)
+                return decode_impl_b64_avx512vbmi<Kind>;
+            if (level >= detail::simd_level::avx2)
+                return decode_impl_b64_avx2<Kind>;
+            if (level >= detail::simd_level::ssse3)
+                return decode_impl_b64_ssse3<Kind>;
+        }
+        else if constexpr (detail::get_family<Kind>() == rfc4648_kind::base32)
+        {
+            if (level >= detail::simd_level::avx2)
+                return decode_impl_b32_avx2<Kind>;
+        }
+        else
+        {
+            if (level >= detail::simd_level::avx2)
+                return decode_impl_b16_avx2<Kind>;
+            if (level >= detail::simd_level::ssse3)
+                return decode_impl_b16_ssse3<Kind>;
+        }
+
+        return nullptr;
+    }();
+
+    return kernel;
+}
+
+// inputs shorter than this are left to the scalar code, the kernels consume
+// nothing below their step and the masked AVX-512 kernel costs more than a few
+// scalar quanta, so tiny inputs such as UUIDs skip the call
+template <rfc4648_kind Kind>
+inline std::size_t get_decode_kernel_min() noexcept
+{
+    static std::size_t const min = []() noexcept -> std::size_t {
+        auto level = detail::get_simd_level();
+
+        if constexpr (detail::get_family<Kind>() == rfc4648_kind::base64)
+            return level >= detail::simd_level::avx512vbmi ? 16 : level >= detail::simd_level::avx2 ? 32 : 16;
+        else
+            return level >= detail::simd_level::avx2 ? 32 : 16;
+    }();
+
+    return min;
+}
+
+// chars that every kernel consumes whole
+inline constexpr std::size_t tail_block_chars = 32;
+
+// decode the len < tail_block_chars chars left by a kernel with the same kernel
+// on a copy filled with the char of value 0, returns false without writing
+// anything if any of the chars is invalid
+template <rfc4648_kind Kind>
+inline bool decode_impl_tail(decode_kernel kernel, unsigned char const *begin, std::size_t len,
+                             unsigned char *&first) noexcept
+{
+    unsigned char in[tail_block_chars];
+    unsigned char out[detail::decoded_size<Kind>(tail_block_chars)];
+
+    std::memset(in, get_char<Kind>(0), tail_block_chars);
+    std::memcpy(in, begin, len);
+
+    if (kernel(in, tail_block_chars, out) != tail_block_chars)
+        return false;
+
+    std::memcpy(first, out, detail::decoded_size<Kind>(len));
+    first += detail::decoded_size<Kind>(len);
+
+    return true;
+}
+
+// the number of leading chars that are in the table, 16 chars at a time, the
+// rest is left to the caller
+template <rfc4648_kind Kind>
+BIZWEN_RFC4648_TARGET_SSSE3 inline std::size_t validate_ssse3(unsigned char const *begin, std::size_t len) noexcept
+{
+    static constexpr auto lut = get_nibble_lut<Kind>();
+
+    auto const lut_lo = _mm_loadu_si128(reinterpret_cast<__m128i const *>(lut.data()));
+    auto const lut_hi = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0);
+    std::size_t i{};
+
+    for (; len - i >= 16; i += 16)
+    {
+        auto in = _mm_loadu_si128(reinterpret_cast<__m128i const *>(begin + i));
+        auto hi_nibbles = _mm_and_si128(_mm_srli_epi16(in, 4), _mm_set1_epi8(15));
+        auto lo_nibbles = _mm_and_si128(in, _mm_set1_epi8(15));
+        auto valid = _mm_and_si128(_mm_shuffle_epi8(lut_lo, lo_nibbles), _mm_shuffle_epi8(lut_hi, hi_nibbles));
+
+        if (auto mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(valid, _mm_setzero_si128()))))
+            return i + std::countr_zero(mask);
+    }
+
+    return i;
+}
+
+// 0xFF for each of the 32 chars that is not in the table
+BIZWEN_RFC4648_TARGET_AVX2 inline __m256i validate_block_avx2(unsigned char const *begin, __m256i lut_lo) noexcept
+{
+    auto const lut_hi = _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 4, 8, 16, 32, 64,
+                                         -128, 0, 0, 0, 0, 0, 0, 0, 0);
+
+    auto in = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(begin));
+    auto hi_nibbles = _mm256_and_si256(_mm256_srli_epi16(in, 4), _mm256_set1_epi8(15));
+    auto lo_nibbles = _mm256_and_si256(in, _mm256_set1_epi8(15));
+    auto valid = _mm256_and_si256(_mm256_shuffle_epi8(lut_lo, lo_nibbles), _mm256_shuffle_epi8(lut_hi, hi_nibbles));
+
+    return _mm256_cmpeq_epi8(valid, _mm256_setzero_si256());
+}
+
+// same as validate_ssse3, 64 chars per iteration
+template <rfc4648_kind Kind>
+BIZWEN_RFC4648_TARGET_AVX2 inline std::size_t validate_avx2(unsigned char const *begin, std::size_t len) noexcept
+{
+    static constexpr auto lut = get_nibble_lut<Kind>();
+
+    auto const lut_lo = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<__m128i const *>(lut.data())));
+
+    std::size_t i{};
+
+    for (; len - i >= 64; i += 64)
+    {
+        auto lo = validate_block_avx2(begin + i, lut_lo);
+        auto hi = validate_block_avx2(begin + i + 32, lut_lo);
+
+        if (_mm256_testz_si256(_mm256_or_si256(lo, hi), _mm256_set1_epi8(-1)))
+            continue;
+
+        auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(lo)) |
+                    static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm256_movemask_epi8(hi))) << 32;
+
+        return i + std::countr_zero(mask);
+    }
+
+    for (; len - i >= 32; i += 32)
+    {
+        if (auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(validate_block_avx2(begin + i, lut_lo))))
+            return i + std::countr_zero(mask);
+    }
+
+    return i;
+}
+
+// same as validate_ssse3 but the tail is loaded with a mask, so all chars are
+// checked
+template <rfc4648_kind Kind>
+BIZWEN_RFC4648_TARGET_AVX512VBMI inline std::size_t validate_avx512(unsigned char const *begin, std::size_t len) noexcept
+{
+    // the luts repeated for each 128-bit lane
+    static constexpr auto luts = []() {
+        auto lut = get_nibble_lut<Kind>();
+        std::array<std::array<unsigned char, 64>, 2> luts{};
+
+        for (std::size_t i{}; i != 64; ++i)
+        {
+            luts[0][i] = lut[i % 16];
+            luts[1][i] = i % 16 < 8 ? static_cast<unsigned char>(1u << i % 16) : 0;
+        }
+
+        return luts;
+    }();
+
+    auto const lut_lo = _mm512_loadu_si512(luts[0].data());
+    auto const lut_hi = _mm512_loadu_si512(luts[1].data());
+
+    for (std::size_t i{}; i < len; i += 64)
+    {
+        auto load = detail::mask_first_n(len - i);
+        auto in = _mm512_maskz_loadu_epi8(load, begin + i);
+        auto hi_nibbles = _mm512_and_si512(_mm512_srli_epi16(in, 4), _mm512_set1_epi8(15));
+        auto lo_nibbles = _mm512_and_si512(in, _mm512_set1_epi8(15));
+        auto mask = _mm512_testn_epi8_mask(_mm512_shuffle_epi8(lut_lo, lo_nibbles),
+                                           _mm512_shuffle_epi8(lut_hi, hi_nibbles)) &
+                    load;
+
+        if (mask)
+            return i + std::countr_zero(mask);
+    }
+
+    return len;
+}
+
+using validate_kernel = std::size_t (*)(unsigned char const *, std::size_t) noexcept;
+
+template <rfc4648_kind Kind>
+inline validate_kernel get_validate_kernel() noexcept
+{
+    static validate_kernel const kernel = []() noexcept -> validate_kernel {
+        auto level = detail::get_simd_level();
+
+        if (level >= detail::simd_level::avx512vbmi)
+            return validate_avx512<Kind>;
+        if (level >= detail::simd_level::avx2)
+            return validate_avx2<Kind>;
+        if (level >= detail::simd_level::ssse3)
+            return validate_ssse3<Kind>;
+
+        return nullptr;
+    }();
+
+    return kernel;
+}
+#endif
+
+// hand the bulk of the input to the vector kernel when the output is narrow
+// and contiguous, only whole quanta before an invalid char are consumed
+// NB: 16 and 32-bit input is narrowed to a stack block first, units above
+// 0xFF become bytes the kernels reject
+template <rfc4648_kind Kind, typename In, typename Out>
+inline constexpr void decode_impl_simd([[maybe_unused]] In &begin, [[maybe_unused]] In end, [[maybe_unused]] Out &first)
+{
+#if defined(BIZWEN_RFC4648_HAS_SIMD)
+    using char_type = std::remove_cvref_t<decltype(*begin)>;
+
+    if constexpr (sizeof(char_type) == 1 && detail::narrow_contiguous_iterator<Out>)
+    {
+#if defined(__cpp_if_consteval) && (__cpp_if_consteval >= 202106L)
+        if !consteval
+#else
+        if (!::std::is_constant_evaluated())
+#endif
+        {
+            auto kernel = get_decode_kernel<Kind>();
+
+            if (kernel && static_cast<std::size_t>(end - begin) >= get_decode_kernel_min<Kind>())
+            {
+                auto in_ptr = reinterpret_cast<unsigned char const *>(begin);
+                auto out_ptr = reinterpret_cast<unsigned char *>(std::to_address(first));
+                // NB: the bytes of an incomplete quantum, which the AVX-512 kernel
+                // decodes before an invalid char, are written again by the caller
+                auto n =
+                    kernel(in_ptr, end - begin, out_ptr) / detail::quantum_chars<Kind> * detail::quantum_chars<Kind>;
+
+                begin += n;
+                first += detail::decoded_size<Kind>(n);
+            }
+        }
+    }
+    else if constexpr ((sizeof(char_type) == 2 || sizeof(char_type) == 4) && detail::narrow_contiguous_iterator<Out>)
+    {
+#if defined(__cpp_if_consteval) && (__cpp_if_consteval >= 202106L)
+        if !consteval
+#else
+        if (!::std::is_constant_evaluated())
+#endif
+        {
+            if (auto kernel = get_decode_kernel<Kind>())
+            {
+                auto narrow = detail::get_simd_level() >= detail::simd_level::avx2 ? narrow_avx2<char_type>
+                                                                                    : narrow_ssse3<char_type>;
+                unsigned char buf[narrow_block_size];
+
+                // NB: a kernel leaves the tail of a block that is shorter than its
+                // step, which is narrowed again with the next block, so it only
+                // stops making progress at an invalid char or the end
+                while (end - begin >= 64)
+                {
+                    auto len = std::min(static_cast<std::size_t>(end - begin), narrow_block_size);
+
+                    narrow(begin, len, buf);
+
+                    auto n = kernel(buf, len, reinterpret_cast<unsigned char *>(std::to_address(first))) /
+                             detail::quantum_chars<Kind> * detail::quantum_chars<Kind>;
+
+                    if (!n)
+                        break;
+
+                    begin += n;
+                    first += detail::decoded_size<Kind>(n);
+                }
+            }
+        }
+    }
+#endif
+}
+
+// decode 8 chars to 5 bytes, returns false without writing anything if any
+// char is invalid
+template <typename In, typename Out>
+inline constexpr bool decode_impl_b32_8(unsigned char const *table, In begin, Out &first)
+{
+    unsigned long long data{};
+    unsigned char check{};
+    bool valid{true};
+
+    for (std::size_t i{}; i != 8; ++i)
+    {
+        auto c = begin[i];
+        auto res = decode_single(table, c);
+
+        valid &= valid_stage1(c);
+        check |= res;
+        data = data << 5 | res;
+    }
+
+    // NB: all values are less than 32 and the invalid value is 0xFF
+    if (!valid || check > 31)
+        return false;
+
+    unsigned char bytes[]{static_cast<unsigned char>(data >> 32), static_cast<unsigned char>(data >> 24),
+                          static_cast<unsigned char>(data >> 16), static_cast<unsigned char>(data >> 8),
+                          static_cast<unsigned char>(data)};
+
+    detail::write_block(bytes, first);
+
+    return true;
+}
+
+// decode whole quanta, stops before the first quantum containing an invalid
+// char and before an incomplete quantum
+template <rfc4648_kind Kind, typename In, typename Out>
+inline constexpr In decode_impl_b32_blocks(unsigned char const *table, In begin, In end, Out &first)
+{
+    decode_impl_simd<Kind>(begin, end, first);
+
+    for (; end - begin > 7; begin += 8)
+    {
+        if (!decode_impl_b32_8(table, begin, first))
+            break;
+    }
+
+    return begin;
+}
+
+template <rfc4648_kind Kind, typename In, typename Out>
+inline constexpr In decode_impl_b32(unsigned char const *table, In begin, In end, Out &first)
+{
+    static_assert(std::is_pointer_v<In>);
+
+    begin = decode_impl_b32_blocks<Kind>(table, begin, end, first);
+
+    // the block containing an invalid char and the incomplete block
+    decode_status_b64_b32 status{};
+
+    for (; begin != end; ++begin)
+    {
+        if (!status.write_b32(table, *begin, first))
+            break;
+    }
+
+    // NB: the bits of an incomplete byte are discarded
+
+    return begin;
+}
+
+// table[i][c] is the value of c shifted to the position of the i-th char of
+// a 4-char quantum, invalid chars have bit 24 set so one test checks a block
+template <rfc4648_kind Kind>
+inline consteval auto get_b64_shifted_table() noexcept
+{
+    auto table = get_table<Kind>();
+    std::array<std::array<std::uint32_t, 256>, 4> shifted{};
+
+    for (std::size_t c{}; c != 256; ++c)
+    {
+        for (std::size_t i{}; i != 4; ++i)
+            shifted[i][c] = valid_stage2(table[c]) ? std::uint32_t(table[c]) << (18 - i * 6) : 0x01000000;
+    }
+
+    return shifted;
+}
+
+template <rfc4648_kind Kind>
+inline constexpr auto b64_shifted_table = get_b64_shifted_table<Kind>();
+
+// the bits above 0xFF of every char, which must be 0
+template <typename In>
+inline constexpr auto high_bits(In begin, std::size_t count) noexcept
+{
+    using u = std::make_unsigned_t<std::remove_cvref_t<decltype(*begin)>>;
+    u bits{};
+
+    if constexpr (sizeof(u) != 1)
+    {
+        for (std::size_t i{}; i != count; ++i)
+            bits |= u(begin[i]) & ~u(0xFF);
+    }
+
+    return bits;
+}
+
+template <rfc4648_kind Kind, typename In>
+inline constexpr std::uint32_t decode_impl_b64_quantum(In begin) noexcept
+{
+    auto &table = b64_shifted_table<Kind>;
+
+    return table[0][static_cast<unsigned char>(begin[0])] | table[1][static_cast<unsigned char>(begin[1])] |
+           table[2][static_cast<unsigned char>(begin[2])] | table[3][static_cast<unsigned char>(begin[3])];
+}
+
+// decode 8 chars to 6 bytes, returns false without writing anything if any
+// char is invalid
+template <rfc4648_kind Kind, typename In, typename Out>
+inline constexpr bool decode_impl_b64_8(In begin, Out &first)
+{
+    auto a = decode_impl_b64_quantum<Kind>(begin);
+    auto b = decode_impl_b64_quantum<Kind>(begin + 4);
+
+    if ((a | b) & 0x01000000 || high_bits(begin, 8))
+        return false;
+
+    unsigned char bytes[]{static_cast<unsigned char>(a >> 16), static_cast<unsigned char>(a >> 8),
+                          static_cast<unsigned char>(a),       static_cast<unsigned char>(b >> 16),
+                          static_cast<unsigned char>(b >> 8),  static_cast<unsigned char>(b)};
+
+    detail::write_block(bytes, first);
+
+    return true;
+}
+
+// decode 4 chars to 3 bytes, returns false without writing anything if any
+// char is invalid
+template <rfc4648_kind Kind, typename In, typename Out>
+inline constexpr bool decode_impl_b64_4(In begin, Out &first)
+{
+    auto a = decode_impl_b64_quantum<Kind>(begin);
+
+    if (a & 0x01000000 || high_bits(begin, 4))
+        return false;
+
+    unsigned char bytes[]{static_cast<unsigned char>(a >> 16), static_cast<unsigned char>(a >> 8),
+                          static_cast<unsigned char>(a)};
+
+    detail::write_block(bytes, first);
+
+    return true;
+}
+
+// decode whole quanta, stops before the first quantum containing an invalid
+// char and before an incomplete quantum
+template <rfc4648_kind Kind, typename In, typename Out>
+inline constexpr In decode_impl_b64_blocks(In begin, In end, Out &first)
+{
+    decode_impl_simd<Kind>(begin, end, first);
+
+    if constexpr (sizeof(std::size_t) == 8)
+    {
+        for (; end - begin > 7; begin += 8)
+        {
+            if (!decode_impl_b64_8<Kind>(begin, first))
+                break;
+        }
+    }
+
+    for (; end - begin > 3; begin += 4)
+    {
+        if (!decode_impl_b64_4<Kind>(begin, first))
+            break;
+    }
+
+    return begin;
+}
+
+template <rfc4648_kind Kind, typename In, typename Out>
+inline constexpr In decode_impl_b64(unsigned char const *table, In begin, In end, Out &first)
+{
+    static_assert(std::is_pointer_v<In>);
+
+    begin = decode_impl_b64_blocks<Kind>(begin, end, first);
+
+    // the block containing an invalid char and the incomplete block
+    decode_status_b64_b32 status{};
+
+    for (; begin != end; ++begin)
+    {
+        if (!status.write_b64(table, *begin, first))
+            break;
+    }
+
+    // NB: the bits of an incomplete byte are discarded
+
+    return begin;
+}
+
+template <rfc4648_kind Kind, bool IgnoreSpace, typename In, typename Out>
+inline constexpr In decode_impl_b64_ctx(unsigned char const *table, detail::sig_ref sig, detail::buf_ref buf, In begin, In end,
+                                        Out &first)
+{
+    static_assert(std::is_pointer_v<In>);
+
+    decode_status_b64_b32 status{sig, buf[0]};
+
+    for (; begin != end; ++begin)
+    {
+        // NB: at a quantum boundary the whole quanta go to the block decoder,
+        // the state machine takes the quantum with an invalid char or space
+        if (!status.sig_)
+        {
+            begin = decode_impl_b64_blocks<Kind>(begin, end, first);
+
+            if (begin == end)
+                break;
+        }
+
+        if constexpr (IgnoreSpace)
+        {
+            if (is_space(*begin))
+                continue;
+        }
+
+        if (!status.write_b64(table, *begin, first))
+            break;
+    }
+
+    sig = status.sig_;
+    buf[0] = status.buf_;
+
+    return begin;
+}
+
+template <rfc4648_kind Kind, bool IgnoreSpace, typename In, typename Out>
+inline constexpr In decode_impl_b32_ctx(unsigned char const *table, detail::sig_ref sig, detail::buf_ref buf, In begin, In end,
+                                        Out &first)
+{
+    static_assert(std::is_pointer_v<In>);
+
+    decode_status_b64_b32 status{sig, buf[0]};
+
+    for (; begin != end; ++begin)
+    {
+        // NB: at a quantum boundary the whole quanta go to the block decoder,
+        // the state machine takes the quantum with an invalid char or space
+        if (!status.sig_)
+        {
+            begin = decode_impl_b32_blocks<Kind>(table, begin, end, first);
+
+            if (begin == end)
+                break;
+        }
+
+        if constexpr (IgnoreSpace)
+        {
+            if (is_space(*begin))
+                continue;
+        }
+
+        if (!status.write_b32(table, *begin, first))
+            break;
+    }
+
+    sig = status.sig_;
+    buf[0] = status.buf_;
+
+    return begin;
+}
+
+template <typename Out>
+inline constexpr void decode_impl_b64_b32_ctx(unsigned char const *, detail::sig_ref sig, detail::buf_ref, Out &)
+{
+    // NB: the bits of an incomplete byte are discarded
+    sig = 0;
+}
+
+// decode whole bytes, stops before the first pair containing an invalid char
+// and before a lone char
+template <rfc4648_kind Kind, typename In, typename Out>
+inline constexpr In decode_impl_b16_blocks(unsigned char const *table, In begin, In end, Out &first)
+{
+    decode_impl_simd<Kind>(begin, end, first);
+
+    for (; end - begin > 1; begin += 2)
+    {
+        auto hi = decode_single(table, begin[0]);
+        auto lo = decode_single(table, begin[1]);
+
+        if (!is_valid(begin[0], hi) || !is_valid(begin[1], lo))
+            break;
+
+        *first = static_cast<unsigned char>(hi << 4 | lo);
+        ++first;
+    }
+
+    return begin;
+}
+
+template <rfc4648_kind Kind, typename In, typename Out>
+inline constexpr In decode_impl_b16(unsigned char const *table, In begin, In end, Out &first)
+{
+    static_assert(std::is_pointer_v<In>);
+
+    begin = decode_impl_b16_blocks<Kind>(table, begin, end, first);
+
+    unsigned char sig{};
+    unsigned char buf;
+
+    for (; begin != end; ++begin)
+    {
+        auto c = *begin;
+        auto res = decode_single(table, c);
+
+        if (!is_valid(c, res))
+            break;
+
+        ++sig;
+
+        if (sig == 1)
+        {
+            buf = res << 4;
+        }
+        else if (sig == 2)
+        {
+            *first = buf | res;
+            ++first;
+            sig = 0;
+        }
+    }
+
+    if (sig)
+    {
+        *first = buf;
+        ++first;
+    }
+
+    return begin;
+}
+
+// copy the chars of [begin, end) that are not ASCII space to out until cap
+// chars are written, returns the end of the copied input and the count written
+template <typename In, typename C>
+inline constexpr std::pair<In, std::size_t> compact_space(In begin, In end, C *out, std::size_t cap) noexcept
+{
+    std::size_t n{};
+
+#if defined(BIZWEN_RFC4648_HAS_SIMD)
+    if constexpr (sizeof(C) == 1)
+    {
+#if defined(__cpp_if_consteval) && (__cpp_if_consteval >= 202106L)
+        if !consteval
+#else
+        if (!::std::is_constant_evaluated())
+#endif
+        {
+            auto level = detail::get_simd_level();
+            auto in_ptr = reinterpret_cast<unsigned char const *>(begin);
+            auto out_ptr = reinterpret_cast<unsigned char *>(out);
+
+            if (level >= detail::simd_level::avx2)
+            {
+                auto [i, m] = compact_space_avx2(in_ptr, end - begin, out_ptr, cap);
+                begin += i;
+                n = m;
+            }
+            else if (level >= detail::simd_level::ssse3)
+            {
+                auto [i, m] = compact_space_ssse3(in_ptr, end - begin, out_ptr, cap);
+                begin += i;
+                n = m;
+            }
+        }
+    }
+#endif
+
+    for (; begin != end && n != cap; ++begin)
+    {
+        if (!is_space(*begin))
+            out[n++] = *begin;
+    }
+
+    return {begin, n};
+}
+
+// the n-th char that is not ASCII space
+template <typename In>
+inline constexpr In skip_space_n(In begin, std::size_t n) noexcept
+{
+    for (;; ++begin)
+    {
+        if (!is_space(*begin) && !n--)
+            return begin;
+    }
+}
+
+// ASCII space is compacted out into a stack buffer, which is decoded in whole
+// quanta, the incomplete quantum is carried to the next round
+template <rfc4648_kind Kind, typename In, typename Out>
+inline constexpr In decode_impl_skip_space(unsigned char const *table, In begin, In end, Out &first)
+{
+    static_assert(std::is_pointer_v<In>);
+
+    using char_type = std::remove_cvref_t<decltype(*begin)>;
+
+    constexpr auto quantum = detail::quantum_chars<Kind>;
+    constexpr std::size_t size = 2048;
+
+    char_type buf[size];
+    std::size_t carried{};
+    // where buf[0] was read from
+    auto carried_begin = begin;
+
+    for (;;)
+    {
+        auto [next, n] = compact_space(begin, end, buf + carried, size - carried);
+        auto len = carried + n;
+        auto whole = next == end ? len : len / quantum * quantum;
+        char_type *stop{};
+
+        if constexpr (detail::get_family<Kind>() == rfc4648_kind::base64)
+            stop = decode_impl_b64<Kind>(table, +buf, buf + whole, first);
+        else if constexpr (detail::get_family<Kind>() == rfc4648_kind::base32)
+            stop = decode_impl_b32<Kind>(table, +buf, buf + whole, first);
+        else
+            stop = decode_impl_b16<Kind>(table, +buf, buf + whole, first);
+
+        if (auto k = static_cast<std::size_t>(stop - buf); k != whole)
+            return k < carried ? skip_space_n(carried_begin, k) : skip_space_n(begin, k - carried);
+
+        if (next == end)
+            return end;
+
+        carried = len - whole;
+
+        for (std::size_t i{}; i != carried; ++i)
+            buf[i] = buf[whole + i];
+
+        // NB: the buffer was full, so the carried chars were all read from [begin, next)
+        carried_begin = next;
+
+        for (std::size_t i{}; i != carried;)
+        {
+            --carried_begin;
+
+            if (!is_space(*carried_begin))
+                ++i;
+        }
+
+        begin = next;
+    }
+}
+
+template <rfc4648_kind Kind, bool IgnoreSpace, typename In, typename Out>
+inline constexpr In decode_impl_b16_ctx(unsigned char const *table, detail::sig_ref sig, detail::buf_ref buf, In begin, In end,
+                                        Out &first)
+{
+    static_assert(std::is_pointer_v<In>);
+
+    for (; begin != end; ++begin)
+    {
+        // NB: same as decode_impl_b64_ctx
+        if (!sig)
+        {
+            begin = decode_impl_b16_blocks<Kind>(table, begin, end, first);
+
+            if (begin == end)
+                break;
+        }
+
+        auto c = *begin;
+
+        if constexpr (IgnoreSpace)
+        {
+            if (is_space(c))
+                continue;
+        }
+
+        auto res = decode_single(table, c);
+
+        if (!is_valid(c, res))
+            break;
+
+        ++sig;
+
+        if (sig == 1)
+        {
+            buf[0] = res << 4;
+            sig = 1;
+        }
+        else if (sig == 2)
+        {
+            *first = buf[0] | res;
+            ++first;
+            sig = 0;
+        }
+        else
+        {
+            std::unreachable();
+        }
+    }
+
+    return begin;
+}
+
+template <typename Out>
+inline constexpr void decode_impl_b16_ctx(unsigned char const *, detail::sig_ref sig, detail::buf_ref buf, Out &first)
+{
+    if (sig)
+    {
+        *first = buf[0];
+        ++first;
+        sig = 0;
+    }
+}
+
+template <rfc4648_kind Kind, typename In, typename Out>
+inline constexpr In decode_impl_any(unsigned char const *table, In begin, In end, Out &first)
+{
+    if constexpr (detail::get_family<Kind>() == rfc4648_kind::base64)
+        return decode_impl_b64<Kind>(table, begin, end, first);
+    else if constexpr (detail::get_family<Kind>() == rfc4648_kind::base32)
+        return decode_impl_b32<Kind>(table, begin, end, first);
+    else
+        return decode_impl_b16<Kind>(table, begin, end, first);
+}
+
+// decode the chars I... of a block of 8, or of the incomplete block at the end,
+// the values are or-ed into check so that the caller tests all chars once
+template <rfc4648_kind Kind, typename In, typename Out, std::size_t... I>
+inline constexpr void decode_impl_fixed_block(unsigned char const *table, In begin, unsigned char &check, Out &first,
+                                              std::index_sequence<I...>)
+{
+    constexpr std::size_t bits = detail::get_family<Kind>() == rfc4648_kind::base64   ? 6
+                                 : detail::get_family<Kind>() == rfc4648_kind::base32 ? 5
+                                                                                      : 4;
+
+    unsigned char res[]{decode_single(table, begin[I])...};
+    unsigned long long data{};
+
+    ((check |= res[I], data = data << bits | res[I]), ...);
+    data <<= (8 - sizeof...(I)) * bits;
+
+    // NB: the bits of an incomplete byte are discarded
+    [&]<std::size_t... J>(std::index_sequence<J...>) {
+        unsigned char bytes[]{static_cast<unsigned char>(data >> (bits * 8 - 8 - J * 8))...};
+
+        detail::write_block(bytes, first);
+    }(std::make_index_sequence<sizeof...(I) * bits / 8>{});
+}
+
+// decode exactly M chars without padding, the blocks are unrolled and every
+// char is tested once at the end
+template <rfc4648_kind Kind, std::size_t M, typename In>
+inline constexpr std::optional<std::array<unsigned char, detail::decoded_size<Kind>(M)>> decode_impl_fixed(In begin)
+{
+    static_assert(detail::encoded_size<Kind, false>(detail::decoded_size<Kind>(M)) == M,
+                  "M chars are not an encoding without padding");
+
+    constexpr auto table = get_table<Kind>();
+    constexpr unsigned char max = detail::get_family<Kind>() == rfc4648_kind::base64   ? 63
+                                  : detail::get_family<Kind>() == rfc4648_kind::base32 ? 31
+                                                                                       : 15;
+
+    std::array<unsigned char, detail::decoded_size<Kind>(M)> bytes;
+    auto first = bytes.data();
+
+#if defined(BIZWEN_RFC4648_HAS_SIMD)
+    // NB: no kernel takes fewer than 16 chars, from the step of the selected
+    // kernel on it is faster than the unrolled code
+    if constexpr (M >= 16)
+    {
+#if defined(__cpp_if_consteval) && (__cpp_if_consteval >= 202106L)
+        if !consteval
+#else
+        if (!::std::is_constant_evaluated())
+#endif
+        {
+            if (get_decode_kernel<Kind>() && M >= get_decode_kernel_min<Kind>())
+            {
+                if (decode_impl_any<Kind>(table, begin, begin + M, first) != begin + M)
+                    return std::nullopt;
+
+                return bytes;
+            }
+        }
+    }
+#endif
+
+    unsigned char check{};
+
+    detail::unroll<M / 8>([&](auto i) {
+        decode_impl_fixed_block<Kind>(table, begin + i * 8, check, first, std::make_index_sequence<8>{});
+    });
+
+    if constexpr (M % 8)
+        decode_impl_fixed_block<Kind>(table, begin + M / 8 * 8, check, first, std::make_index_sequence<M % 8>{});
+
+    // NB: all values are at most max and the invalid value is 0xFF
+    if (check > max || high_bits(begin, M))
+        return std::nullopt;
+
+    return bytes;
+}
+
+#if defined(BIZWEN_RFC4648_HAS_SIMD)
+// decode one message of a batch up to its first invalid char, kernel is
+// resolved once per batch, returns the number of chars decoded
+template <rfc4648_kind Kind, typename C>
+inline std::size_t decode_impl_batch_item(decode_kernel kernel, C const *begin, std::size_t len,
+                                          unsigned char *&first) noexcept
+{
+    auto in_ptr = reinterpret_cast<unsigned char const *>(begin);
+    auto n = kernel(in_ptr, len, first) / detail::quantum_chars<Kind> * detail::quantum_chars<Kind>;
+
+    first += detail::decoded_size<Kind>(n);
+
+    if (n == len)
+        return n;
+
+    // NB: decoding stops at padding, so it is not passed to the tail kernel
+    auto end = len;
+
+    while (end != n && begin[end - 1] == '=')
+        --end;
+
+    if (end - n < tail_block_chars && decode_impl_tail<Kind>(kernel, in_ptr + n, end - n, first))
+        return end;
+
+    // the quantum with the invalid char
+    auto last = begin + n;
+
+    if constexpr (detail::get_family<Kind>() == rfc4648_kind::base64)
+        last = decode_impl_b64<Kind>(get_table<Kind>(), last, begin + len, first);
+    else if constexpr (detail::get_family<Kind>() == rfc4648_kind::base32)
+        last = decode_impl_b32<Kind>(get_table<Kind>(), last, begin + len, first);
+    else
+        last = decode_impl_b16<Kind>(get_table<Kind>(), last, begin + len, first);
+
+    return static_cast<std::size_t>(last - begin);
+}
+#endif
+
+// split [begin, end) at quantum boundaries into one chunk per thread, each chunk
+// is decoded to its precomputed offset, the first chunk that stops early has
+// the globally first invalid char
+template <rfc4648_kind Kind, typename In, typename Out>
+inline In decode_impl_parallel(std::size_t threads, unsigned char const *table, In begin, In end, Out &first)
+{
+    using diff = std::iter_difference_t<Out>;
+
+    auto size = static_cast<std::size_t>(end - begin);
+    auto chunk = size / threads / detail::quantum_chars<Kind> * detail::quantum_chars<Kind>;
+
+    if (!chunk)
+        threads = 1;
+
+    // where each chunk stopped
+    std::vector<std::pair<In, Out>> results(threads);
+
+    detail::parallel_for(threads, [&](std::size_t i) {
+        auto chunk_begin = begin + i * chunk;
+        auto chunk_end = i + 1 == threads ? end : chunk_begin + chunk;
+        auto chunk_first = first + static_cast<diff>(detail::decoded_size<Kind>(i * chunk));
+        auto last = decode_impl_any<Kind>(table, chunk_begin, chunk_end, chunk_first);
+
+        results[i] = {last, chunk_first};
+    });
+
+    std::size_t i{};
+
+    while (i + 1 != threads && results[i].first == begin + (i + 1) * chunk)
+        ++i;
+
+    first = results[i].second;
+
+    return results[i].first;
+}
+
+// the first char that is not in the table
+template <rfc4648_kind Kind, typename In>
+inline constexpr In validate_impl_chars(unsigned char const *table, In begin, In end)
+{
+    static_assert(std::is_pointer_v<In>);
+
+#if defined(BIZWEN_RFC4648_HAS_SIMD)
+    if constexpr (sizeof(*begin) == 1)
+    {
+#if defined(__cpp_if_consteval) && (__cpp_if_consteval >= 202106L)
+        if !consteval
+#else
+        if (!::std::is_constant_evaluated())
+#endif
+        {
+            if (auto kernel = get_validate_kernel<Kind>())
+                begin += kernel(reinterpret_cast<unsigned char const *>(begin), end - begin);
+        }
+    }
+#endif
+
+    auto value = [table](auto c) noexcept { return valid_stage1(c) ? decode_single(table, c) : 0xFF; };
+
+    // NB: all values are less than 64 and the invalid value is 0xFF
+    for (; end - begin > 7; begin += 8)
+    {
+        if ((value(begin[0]) | value(begin[1]) | value(begin[2]) | value(begin[3]) | value(begin[4]) |
+             value(begin[5]) | value(begin[6]) | value(begin[7])) > 63)
+            break;
+    }
+
+    for (; begin != end && is_valid(*begin, decode_single(table, *begin)); ++begin)
+        ;
+
+    return begin;
+}
+
+// the end of the valid encoding at the start of [begin, end) and the number of
+// bytes decoded from the chars before it
+template <rfc4648_kind Kind, typename In>
+inline constexpr std::pair<In, std::size_t> validate_impl(unsigned char const *table, In begin, In end)
+{
+    constexpr std::size_t bits = detail::get_family<Kind>() == rfc4648_kind::base64   ? 6
+                                 : detail::get_family<Kind>() == rfc4648_kind::base32 ? 5
+                                                                                      : 4;
+
+    auto last = validate_impl_chars<Kind>(table, begin, end);
+    auto n = static_cast<std::size_t>(last - begin);
+    auto rem = n % detail::quantum_chars<Kind>;
+    auto size = detail::decoded_size<Kind>(n);
+    bool padding = detail::get_family<Kind>() != rfc4648_kind::base16 && last != end && *last == '=';
+
+    if (last != end && !padding)
+        return {last, size};
+
+    // the last char must end in a byte and its unused bits must be zero
+    auto unused = rem * bits % 8;
+
+    if (rem && (unused >= bits || (decode_single(table, last[-1]) & ((1u << unused) - 1))))
+        return {last - 1, detail::decoded_size<Kind>(n - 1)};
+
+    if (!padding || !rem)
+        return {last, size};
+
+    // exactly the padding of the last quantum and nothing after it
+    auto pad = detail::quantum_chars<Kind> - rem;
+    auto pad_end = last;
+
+    for (; pad_end != end && *pad_end == '=' && static_cast<std::size_t>(pad_end - last) != pad; ++pad_end)
+        ;
+
+    if (static_cast<std::size_t>(pad_end - last) != pad)
+        return {last, size};
+
+    return {pad_end, size};
+}
+
+template <typename End, typename Out>
+struct rfc4648_decode_result
+{
+    End end;
+    Out out;
+};
+
+struct rfc4648_decode_fn
+{
+    template <rfc4648_kind Kind = rfc4648_kind::base64, bool IgnoreSpace = false, typename In, typename Out>
+#if defined(__cpp_static_call_operator) && __cpp_static_call_operator >= 202207L
+    static
+#endif
+        inline constexpr rfc4648_decode_result<In, Out>
+        operator()(In begin, In end, Out first)
+#if !defined(__cpp_static_call_operator) || __cpp_static_call_operator < 202207L
+            const
+#endif
+    {
+        using in_char = std::iterator_traits<In>::value_type;
+
+        static_assert(std::contiguous_iterator<In>);
+        static_assert(std::is_same_v<in_char, char> || std::is_same_v<in_char, wchar_t> ||
+                      std::is_same_v<in_char, char8_t> || std::is_same_v<in_char, char16_t> ||
+                      std::is_same_v<in_char, char32_t>);
+
+        auto begin_ptr = detail::to_address_const(begin);
+        auto end_ptr = detail::to_address_const(end);
+
+        // NB: a string or vector is grown once and written through a pointer
+        if constexpr (detail::contiguous_back_inserter<Out>)
+        {
+            auto n = detail::decoded_size<Kind>(static_cast<std::size_t>(end_ptr - begin_ptr));
+            auto last = begin;
+
+            detail::append_and_fill(detail::get_container(first), n, [begin_ptr, end_ptr, &last](auto ptr) {
+                auto [end, out] = rfc4648_decode_fn{}.operator()<Kind, IgnoreSpace>(begin_ptr, end_ptr, ptr);
+                last += end - begin_ptr;
+
+                return static_cast<std::size_t>(out - ptr);
+            });
+
+            return {last, std::move(first)};
+        }
+
+        decltype(begin_ptr) last_ptr = {};
+
+        if constexpr (IgnoreSpace)
+            last_ptr =
+                decode_impl::decode_impl_skip_space<Kind>(decode_impl::get_table<Kind>(), begin_ptr, end_ptr, first);
+        else if constexpr (detail::get_family<Kind>() == rfc4648_kind::base64)
+            last_ptr = decode_impl::decode_impl_b64<Kind>(decode_impl::get_table<Kind>(), begin_ptr, end_ptr, first);
+        else if constexpr (detail::get_family<Kind>() == rfc4648_kind::base32)
+            last_ptr = decode_impl::decode_impl_b32<Kind>(decode_impl::get_table<Kind>(), begin_ptr, end_ptr, first);
+        else
+            last_ptr = decode_impl::decode_impl_b16<Kind>(decode_impl::get_table<Kind>(), begin_ptr, end_ptr, first);
+
+        return {begin + (last_ptr - begin_ptr), std::move(first)};
+    }
+
+    template <rfc4648_kind Kind = rfc4648_kind::base64, bool IgnoreSpace = false, typename R, typename Out>
 #if defined(__cpp_static_call_operator) && __cpp_static_call_operator >= 202207L
     static
 #endif
         inline constexpr auto
-        operator()(rfc4648_context &ctx, R &&r, Out first)
+        operator()(R &&r, Out first)
+#if !defined(__cpp_static_call_operator) || __cpp_static_call_operator < 202207L
+            const
+#endif
+    {
+        return operator()<Kind, IgnoreSpace>(std::ranges::begin(r), std::ranges::end(r), first);
+    }
+
+    // NB: the chars are an encoding without padding of a length known at
+    // compile time, the bytes are returned by value, or nullopt if any char is
+    // invalid
+    template <rfc4648_kind Kind = rfc4648_kind::base64, typename C, std::size_t M>
+        requires(M != std::dynamic_extent)
+#if defined(__cpp_static_call_operator) && __cpp_static_call_operator >= 202207L
+    static
+#endif
+        inline constexpr std::optional<std::array<unsigned char, detail::decoded_size<Kind>(M)>>
+        operator()(std::span<C, M> chars)
+#if !defined(__cpp_static_call_operator) || __cpp_static_call_operator < 202207L
+            const
+#endif
+    {
+        using in_char = std::remove_cv_t<C>;
+
+        static_assert(std::is_same_v<in_char, char> || std::is_same_v<in_char, wchar_t> ||
+                      std::is_same_v<in_char, char8_t> || std::is_same_v<in_char, char16_t> ||
+                      std::is_same_v<in_char, char32_t>);
+
+        return decode_impl::decode_impl_fixed<Kind, M>(chars.data());
+    }
+
+    template <rfc4648_kind Kind = rfc4648_kind::base64, typename C, std::size_t M>
+#if defined(__cpp_static_call_operator) && __cpp_static_call_operator >= 202207L
+    static
+#endif
+        inline constexpr std::optional<std::array<unsigned char, detail::decoded_size<Kind>(M)>>
+        operator()(std::array<C, M> const &chars)
 #if !defined(__cpp_static_call_operator) || __cpp_static_call_operator < 202207L
             const
 #endif
     {
-        return operator()<Kind>(ctx, std::ranges::begin(r), std::ranges::end(r), first);
+        return rfc4648_decode_fn{}.operator()<Kind>(std::span<C const, M>{chars});
     }
 
+    // NB: runs on one thread unless Out is random access, on invalid input the
+    // output after out may have been written
     template <rfc4648_kind Kind = rfc4648_kind::base64, typename In, typename Out>
 #if defined(__cpp_static_call_operator) && __cpp_static_call_operator >= 202207L
     static
 #endif
-        inline constexpr Out
-        operator()(rfc4648_context &ctx, Out first)
+        inline rfc4648_decode_result<In, Out>
+        operator()(rfc4648_parallel parallel, In begin, In end, Out first)
+#if !defined(__cpp_static_call_operator) || __cpp_static_call_operator < 202207L
+            const
+#endif
+    {
+        using in_char = std::iterator_traits<In>::value_type;
+
+        static_assert(std::contiguous_iterator<In>);
+        static_assert(std::is_same_v<in_char, char> || std::is_same_v<in_char, wchar_t> ||
+                      std::is_same_v<in_char, char8_t> || std::is_same_v<in_char, char16_t> ||
+                      std::is_same_v<in_char, char32_t>);
+
+        auto begin_ptr = detail::to_address_const(begin);
+        auto end_ptr = detail::to_address_const(end);
+        auto threads = detail::get_thread_count(parallel, static_cast<std::size_t>(end_ptr - begin_ptr));
+
+        decltype(begin_ptr) last_ptr = {};
+
+        if constexpr (std::random_access_iterator<Out>)
+            last_ptr = decode_impl::decode_impl_parallel<Kind>(threads, decode_impl::get_table<Kind>(), begin_ptr,
+                                                               end_ptr, first);
+        else
+            last_ptr = decode_impl::decode_impl_any<Kind>(decode_impl::get_table<Kind>(), begin_ptr, end_ptr, first);
+
+        return {begin + (last_ptr - begin_ptr), std::move(first)};
+    }
+
+    template <rfc4648_kind Kind = rfc4648_kind::base64, typename R, typename Out>
+#if defined(__cpp_static_call_operator) && __cpp_static_call_operator >= 202207L
+    static
+#endif
+        inline auto
+        operator()(rfc4648_parallel parallel, R &&r, Out first)
+#if !defined(__cpp_static_call_operator) || __cpp_static_call_operator < 202207L
+            const
+#endif
+    {
+        return operator()<Kind>(parallel, std::ranges::begin(r), std::ranges::end(r), first);
+    }
+
+    template <rfc4648_kind Kind = rfc4648_kind::base64, bool IgnoreSpace = false, typename In, typename Out>
+#if defined(__cpp_static_call_operator) && __cpp_static_call_operator >= 202207L
+    static
+#endif
+        inline constexpr rfc4648_decode_result<In, Out>
+        operator()(rfc4648_context &ctx, In begin, In end, Out first)
 #if !defined(__cpp_static_call_operator) || __cpp_static_call_operator < 202207L
             const
 #endif
@@ -649,6 +2129,65 @@ struct rfc4648_decode_fn
                       std::is_same_v<in_char, char8_t> || std::is_same_v<in_char, char16_t> ||
                       std::is_same_v<in_char, char32_t>);
 
+        auto begin_ptr = detail::to_address_const(begin);
+        auto end_ptr = detail::to_address_const(end);
+
+        if constexpr (detail::contiguous_back_inserter<Out>)
+        {
+            auto n = detail::decoded_size<Kind>(static_cast<std::size_t>(end_ptr - begin_ptr)) +
+                     detail::quantum_bytes<Kind>;
+            auto last = begin;
+
+            detail::append_and_fill(detail::get_container(first), n, [&ctx, begin_ptr, end_ptr, &last](auto ptr) {
+                auto [end, out] = rfc4648_decode_fn{}.operator()<Kind, IgnoreSpace>(ctx, begin_ptr, end_ptr, ptr);
+                last += end - begin_ptr;
+
+                return static_cast<std::size_t>(out - ptr);
+            });
+
+            return {last, std::move(first)};
+        }
+
+        decltype(begin_ptr) last_ptr = {};
+
+        if constexpr (detail::get_family<Kind>() == rfc4648_kind::base64)
+            last_ptr = decode_impl::decode_impl_b64_ctx<Kind, IgnoreSpace>(decode_impl::get_table<Kind>(), ctx.sig_,
+                                                                           ctx.buf_, begin_ptr, end_ptr, first);
+        if constexpr (detail::get_family<Kind>() == rfc4648_kind::base32)
+            last_ptr = decode_impl::decode_impl_b32_ctx<Kind, IgnoreSpace>(decode_impl::get_table<Kind>(), ctx.sig_,
+                                                                           ctx.buf_, begin_ptr, end_ptr, first);
+        ;
+        if constexpr (detail::get_family<Kind>() == rfc4648_kind::base16)
+            last_ptr = decode_impl::decode_impl_b16_ctx<Kind, IgnoreSpace>(decode_impl::get_table<Kind>(), ctx.sig_,
+                                                                           ctx.buf_, begin_ptr, end_ptr, first);
+        ;
+
+        return {begin + (last_ptr - begin_ptr), std::move(first)};
+    }
+
+    template <rfc4648_kind Kind = rfc4648_kind::base64, bool IgnoreSpace = false, typename R, typename Out>
+#if defined(__cpp_static_call_operator) && __cpp_static_call_operator >= 202207L
+    static
+#endif
+        inline constexpr auto
+        operator()(rfc4648_context &ctx, R &&r, Out first)
+#if !defined(__cpp_static_call_operator) || __cpp_static_call_operator < 202207L
+            const
+#endif
+    {
+        return operator()<Kind, IgnoreSpace>(ctx, std::ranges::begin(r), std::ranges::end(r), first);
+    }
+
+    template <rfc4648_kind Kind = rfc4648_kind::base64, typename Out>
+#if defined(__cpp_static_call_operator) && __cpp_static_call_operator >= 202207L
+    static
+#endif
+        inline constexpr Out
+        operator()(rfc4648_context &ctx, Out first)
+#if !defined(__cpp_static_call_operator) || __cpp_static_call_operator < 202207L
+            const
+#endif
+    {
         if constexpr (detail::get_family<Kind>() == rfc4648_kind::base64)
             decode_impl::decode_impl_b64_b32_ctx(decode_impl::get_table<Kind>(), ctx.sig_, ctx.buf_, first);
         if constexpr (detail::get_family<Kind>() == rfc4648_kind::base32)
@@ -660,8 +2199,163 @@ struct rfc4648_decode_fn
     }
 };
 
+struct rfc4648_decode_to_fn
+{
+    // NB: replaces the content of c, which is shrunk to the decoded bytes
+    template <rfc4648_kind Kind = rfc4648_kind::base64, bool IgnoreSpace = false, typename R, typename C>
+#if defined(__cpp_static_call_operator) && __cpp_static_call_operator >= 202207L
+    static
+#endif
+        inline constexpr std::ranges::borrowed_iterator_t<R>
+        operator()(R &&r, C &c)
+#if !defined(__cpp_static_call_operator) || __cpp_static_call_operator < 202207L
+            const
+#endif
+    {
+        auto n = detail::decoded_size<Kind>(std::ranges::size(r));
+        auto last = std::ranges::begin(r);
+
+        detail::resize_and_fill(c, n, [&r, &last](auto ptr) {
+            auto [end, out] = rfc4648_decode_fn{}.operator()<Kind, IgnoreSpace>(r, ptr);
+            last = end;
+
+            return static_cast<std::size_t>(out - ptr);
+        });
+
+        return last;
+    }
+};
+
+// end is the number of chars of the message before its first invalid char,
+// size is the number of bytes written for it
+struct rfc4648_decode_batch_result
+{
+    std::size_t end;
+    std::size_t size;
+};
+
+struct rfc4648_decode_batch_fn
+{
+    // NB: the messages are written back to back from first, an
+    // rfc4648_decode_batch_result for each is written to results
+    template <rfc4648_kind Kind = rfc4648_kind::base64, bool IgnoreSpace = false, typename R, typename Out,
+              typename Results>
+#if defined(__cpp_static_call_operator) && __cpp_static_call_operator >= 202207L
+    static
+#endif
+        inline constexpr Out
+        operator()(R &&messages, Out first, Results results)
+#if !defined(__cpp_static_call_operator) || __cpp_static_call_operator < 202207L
+            const
+#endif
+    {
+        using message = std::ranges::range_reference_t<R>;
+
+        static_assert(std::ranges::contiguous_range<message> && std::ranges::sized_range<message>);
+        static_assert(std::random_access_iterator<Out>);
+
+#if defined(BIZWEN_RFC4648_HAS_SIMD)
+        if constexpr (!IgnoreSpace && sizeof(std::ranges::range_value_t<message>) == 1 &&
+                      detail::narrow_contiguous_iterator<Out>)
+        {
+#if defined(__cpp_if_consteval) && (__cpp_if_consteval >= 202106L)
+            if !consteval
+#else
+            if (!::std::is_constant_evaluated())
+#endif
+            {
+                if (auto kernel = decode_impl::get_decode_kernel<Kind>())
+                {
+                    auto out = reinterpret_cast<unsigned char *>(std::to_address(first));
+
+                    for (auto &&m : messages)
+                    {
+                        auto last = out;
+                        auto end = decode_impl::decode_impl_batch_item<Kind>(kernel, std::ranges::data(m),
+                                                                             std::ranges::size(m), last);
+
+                        *results = rfc4648_decode_batch_result{end, static_cast<std::size_t>(last - out)};
+                        ++results;
+                        out = last;
+                    }
+
+                    return first + (out - reinterpret_cast<unsigned char *>(std::to_address(first)));
+                }
+            }
+        }
+#endif
+
+        for (auto &&m : messages)
+        {
+            auto [end, last] = rfc4648_decode_fn{}.operator()<Kind, IgnoreSpace>(m, first);
+
+            *results = rfc4648_decode_batch_result{static_cast<std::size_t>(end - std::ranges::begin(m)),
+                                                   static_cast<std::size_t>(last - first)};
+            ++results;
+            first = last;
+        }
+
+        return first;
+    }
+};
+
+template <typename End>
+struct rfc4648_validate_result
+{
+    End end;
+    std::size_t size;
+};
+
+struct rfc4648_validate_fn
+{
+    // NB: end is the end of the input if it is valid, size is the number of
+    // bytes rfc4648_decode writes for [begin, end)
+    template <rfc4648_kind Kind = rfc4648_kind::base64, typename In>
+#if defined(__cpp_static_call_operator) && __cpp_static_call_operator >= 202207L
+    static
+#endif
+        inline constexpr rfc4648_validate_result<In>
+        operator()(In begin, In end)
+#if !defined(__cpp_static_call_operator) || __cpp_static_call_operator < 202207L
+            const
+#endif
+    {
+        using in_char = std::iterator_traits<In>::value_type;
+
+        static_assert(std::contiguous_iterator<In>);
+        static_assert(std::is_same_v<in_char, char> || std::is_same_v<in_char, wchar_t> ||
+                      std::is_same_v<in_char, char8_t> || std::is_same_v<in_char, char16_t> ||
+                      std::is_same_v<in_char, char32_t>);
+
+        auto begin_ptr = detail::to_address_const(begin);
+        auto end_ptr = detail::to_address_const(end);
+
+        auto [last_ptr, size] = decode_impl::validate_impl<Kind>(decode_impl::get_table<Kind>(), begin_ptr, end_ptr);
+
+        return {begin + (last_ptr - begin_ptr), size};
+    }
+
+    template <rfc4648_kind Kind = rfc4648_kind::base64, typename R>
+#if defined(__cpp_static_call_operator) && __cpp_static_call_operator >= 202207L
+    static
+#endif
+        inline constexpr auto
+        operator()(R &&r)
+#if !defined(__cpp_static_call_operator) || __cpp_static_call_operator < 202207L
+            const
+#endif
+    {
+        return operator()<Kind>(std::ranges::begin(r), std::ranges::end(r));
+    }
+};
+
 } // namespace decode_impl
 
 using decode_impl::rfc4648_decode_result;
+using decode_impl::rfc4648_decode_batch_result;
+using decode_impl::rfc4648_validate_result;
 inline constexpr decode_impl::rfc4648_decode_fn rfc4648_decode;
+inline constexpr decode_impl::rfc4648_decode_to_fn rfc4648_decode_to;
+inline constexpr decode_impl::rfc4648_decode_batch_fn rfc4648_decode_batch;
+inline constexpr decode_impl::rfc4648_validate_fn rfc4648_validate;
 } // namespace bizwen
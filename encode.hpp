@@ -1,12 +1,19 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
 #include <bit>
 #include <concepts>
+#include <cstdint>
 #include <cstring>
 #include <iterator>
+#include <span>
+#include <string_view>
+#include <utility>
 
 #include "./common.hpp"
+#include "./parallel.hpp"
+#include "./simd.hpp"
 
 namespace bizwen
 {
@@ -58,6 +65,32 @@ inline consteval auto get_alphabet() noexcept
         return pattern::base16_lower;
 }
 
+// the Count bytes at begin as a little endian integer, loaded in power of two
+// pieces, a partial memcpy into a wider integer would stall store forwarding
+template <std::size_t Count, typename T>
+inline unsigned long long load_little_endian(T begin) noexcept
+{
+    if constexpr (Count == 0)
+    {
+        return 0;
+    }
+    else
+    {
+        constexpr auto part = std::bit_floor(Count);
+        using part_type = std::conditional_t<
+            part == 1, unsigned char,
+            std::conditional_t<part == 2, std::uint16_t, std::conditional_t<part == 4, std::uint32_t, std::uint64_t>>>;
+
+        part_type data;
+        std::memcpy(&data, begin, part);
+
+        if constexpr (Count == part)
+            return data;
+        else
+            return data | load_little_endian<Count - part>(begin + part) << (part * 8);
+    }
+}
+
 template <std::size_t Count, typename T>
 inline constexpr auto chars_to_int_big_endian(T begin)
 {
@@ -87,14 +120,528 @@ inline constexpr auto chars_to_int_big_endian(T begin)
     }
     else
     {
-        data_type buf{};
-
-        std::memcpy(&buf, begin, Count);
-
         if constexpr (std::endian::native == std::endian::little)
-            return std::byteswap(buf);
+        {
+            return std::byteswap(static_cast<data_type>(load_little_endian<Count>(begin)));
+        }
         else
+        {
+            data_type buf{};
+
+            std::memcpy(&buf, begin, Count);
+
             return buf;
+        }
+    }
+}
+
+#if defined(BIZWEN_RFC4648_HAS_SIMD)
+// the four 6-bit indices of each 32-bit lane are extracted with multiplies,
+// the alphabet is then reached by adding a per-range offset
+BIZWEN_RFC4648_TARGET_AVX2 inline __m256i encode_impl_b64_avx2_block(__m256i in, __m256i offset) noexcept
+{
+    auto t0 = _mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00));
+    auto t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+    auto t2 = _mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0));
+    auto t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+    auto indices = _mm256_or_si256(t1, t3);
+
+    auto reduced = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+    auto less = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+    reduced = _mm256_or_si256(reduced, _mm256_and_si256(less, _mm256_set1_epi8(13)));
+
+    return _mm256_add_epi8(_mm256_shuffle_epi8(offset, reduced), indices);
+}
+
+// 24 bytes -> 32 chars per iteration, returns the number of bytes consumed
+// the bytes are regrouped with pshufb, only alphabet[62] and alphabet[63] are
+// read
+BIZWEN_RFC4648_TARGET_AVX2 inline std::size_t encode_impl_b64_avx2(char8_t const *alphabet, unsigned char const *begin,
+                                                                   std::size_t len, unsigned char *first) noexcept
+{
+    auto const shuffle = _mm256_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10, 1, 0, 2, 1, 4, 3, 5, 4, 7,
+                                          6, 8, 7, 10, 9, 11, 10);
+    // 0 - 25 -> 13, 26 - 51 -> 0, 52 - 61 -> 1 - 10, 62 -> 11, 63 -> 12
+    auto const offset = _mm256_setr_epi8(
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        static_cast<char>(alphabet[62] - 62), static_cast<char>(alphabet[63] - 63), 'A', 0, 0, 'a' - 26, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        static_cast<char>(alphabet[62] - 62), static_cast<char>(alphabet[63] - 63), 'A', 0, 0);
+
+    std::size_t i{};
+
+    // NB: each iteration reads 28 bytes
+    for (; len - i >= 28; i += 24, first += 32)
+    {
+        auto lo = _mm_loadu_si128(reinterpret_cast<__m128i const *>(begin + i));
+        auto hi = _mm_loadu_si128(reinterpret_cast<__m128i const *>(begin + i + 12));
+        auto in = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+
+        in = _mm256_shuffle_epi8(in, shuffle);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(first), encode_impl_b64_avx2_block(in, offset));
+    }
+
+    // the last block loads its high half 4 bytes earlier to stay in bounds
+    if (len - i >= 24)
+    {
+        auto const shuffle_last = _mm256_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10, 5, 4, 6, 5, 8, 7,
+                                                   9, 8, 11, 10, 12, 11, 14, 13, 15, 14);
+
+        auto lo = _mm_loadu_si128(reinterpret_cast<__m128i const *>(begin + i));
+        auto hi = _mm_loadu_si128(reinterpret_cast<__m128i const *>(begin + i + 8));
+        auto in = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+
+        in = _mm256_shuffle_epi8(in, shuffle_last);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(first), encode_impl_b64_avx2_block(in, offset));
+        i += 24;
+    }
+
+    return i;
+}
+
+// 48 bytes -> 64 chars per iteration, the tail is encoded by the same code
+// with masked loads and stores, so the whole input is consumed
+template <bool Padding>
+BIZWEN_RFC4648_TARGET_AVX512VBMI inline std::size_t encode_impl_b64_avx512vbmi(char8_t const *alphabet,
+                                                                               unsigned char const *begin,
+                                                                               std::size_t len,
+                                                                               unsigned char *first) noexcept
+{
+    // each 32-bit lane holds the bytes b, a, c, b of a 3-byte group
+    auto const shuffle = _mm512_setr_epi32(0x01020001, 0x04050304, 0x07080607, 0x0a0b090a, 0x0d0e0c0d, 0x10110f10,
+                                           0x13141213, 0x16171516, 0x191a1819, 0x1c1d1b1c, 0x1f201e1f, 0x22232122,
+                                           0x25262425, 0x28292728, 0x2b2c2a2b, 0x2e2f2d2e);
+    auto const shifts = _mm512_set1_epi64(0x3036242a1016040a);
+    auto const lookup = _mm512_loadu_si512(alphabet);
+
+    for (std::size_t i{}; i < len; i += 48)
+    {
+        auto n = len - i < 48 ? len - i : 48;
+        auto in = _mm512_maskz_loadu_epi8(detail::mask_first_n(n), begin + i);
+
+        in = _mm512_permutexvar_epi8(shuffle, in);
+        auto result = _mm512_permutexvar_epi8(_mm512_multishift_epi64_epi8(shifts, in), lookup);
+
+        auto chars = (n * 4 + 2) / 3;
+        auto count = Padding ? (n + 2) / 3 * 4 : chars;
+
+        if constexpr (Padding)
+            result = _mm512_mask_mov_epi8(result, detail::mask_first_n(count) & ~detail::mask_first_n(chars),
+                                          _mm512_set1_epi8(static_cast<char>(alphabet[64])));
+
+        _mm512_mask_storeu_epi8(first, detail::mask_first_n(count), result);
+        first += count;
+    }
+
+    return len;
+}
+
+// the 16-bit lane i of a 128-bit lane holds the bytes covering the 5-bit
+// group i of the 5-byte group starting at Offset, in big endian
+template <std::size_t OffsetLo, std::size_t OffsetHi>
+inline consteval auto get_b32_shuffle() noexcept
+{
+    constexpr unsigned char pos[8] = {0, 0, 1, 1, 2, 3, 3, 4};
+    std::array<char, 32> ctl{};
+
+    for (std::size_t i{}; i != 8; ++i)
+    {
+        ctl[i * 2] = static_cast<char>(pos[i] + 1 + OffsetLo);
+        ctl[i * 2 + 1] = static_cast<char>(pos[i] + OffsetLo);
+        ctl[i * 2 + 16] = static_cast<char>(pos[i] + 1 + OffsetHi);
+        ctl[i * 2 + 17] = static_cast<char>(pos[i] + OffsetHi);
+    }
+
+    // NB: the last group only needs byte 4, don't read past the group
+    ctl[14] = ctl[30] = -128;
+
+    return ctl;
+}
+
+// extract the eight 5-bit indices of the two 5-byte groups and map them to
+// chars, lo and hi must be loaded at the offsets of ctl
+BIZWEN_RFC4648_TARGET_AVX2 inline __m256i encode_impl_b32_group_avx2(__m128i lo, __m128i hi,
+                                                                     std::array<char, 32> const &ctl) noexcept
+{
+    // x >> s == mulhi(x, 1 << (16 - s)), s is 11, 6, 9, 4, 7, 10, 5, 8
+    auto const shifts = _mm256_setr_epi16(1 << 5, 1 << 10, 1 << 7, 1 << 12, 1 << 9, 1 << 6, 1 << 11, 1 << 8, 1 << 5,
+                                          1 << 10, 1 << 7, 1 << 12, 1 << 9, 1 << 6, 1 << 11, 1 << 8);
+
+    auto in = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+    in = _mm256_shuffle_epi8(in, _mm256_loadu_si256(reinterpret_cast<__m256i const *>(ctl.data())));
+
+    return _mm256_and_si256(_mm256_mulhi_epu16(in, shifts), _mm256_set1_epi16(31));
+}
+
+BIZWEN_RFC4648_TARGET_AVX2 inline __m256i encode_impl_b32_lookup_avx2(__m256i indices, __m256i alphabet_lo,
+                                                                      __m256i alphabet_hi) noexcept
+{
+    auto lo = _mm256_shuffle_epi8(alphabet_lo, indices);
+    auto hi = _mm256_shuffle_epi8(alphabet_hi, indices);
+
+    return _mm256_blendv_epi8(lo, hi, _mm256_cmpgt_epi8(indices, _mm256_set1_epi8(15)));
+}
+
+// 40 bytes -> 64 chars per iteration, returns the number of bytes consumed
+// the eight 5-byte groups are placed one per 128-bit lane, loads near the end
+// of the block are moved back so that no byte past the block is read
+BIZWEN_RFC4648_TARGET_AVX2 inline std::size_t encode_impl_b32_avx2(char8_t const *alphabet, unsigned char const *begin,
+                                                                   std::size_t len, unsigned char *first) noexcept
+{
+    static constexpr auto ctl = get_b32_shuffle<0, 0>();
+    static constexpr auto ctl_g6 = get_b32_shuffle<0, 6>();
+    static constexpr auto ctl_g5_g7 = get_b32_shuffle<1, 11>();
+
+    auto const alphabet_lo = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<__m128i const *>(alphabet)));
+    auto const alphabet_hi =
+        _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<__m128i const *>(alphabet + 16)));
+
+    std::size_t i{};
+
+    for (; len - i >= 40; i += 40, first += 64)
+    {
+        auto g0 = _mm_loadu_si128(reinterpret_cast<__m128i const *>(begin + i));
+        auto g1 = _mm_loadu_si128(reinterpret_cast<__m128i const *>(begin + i + 5));
+        auto g2 = _mm_loadu_si128(reinterpret_cast<__m128i const *>(begin + i + 10));
+        auto g3 = _mm_loadu_si128(reinterpret_cast<__m128i const *>(begin + i + 15));
+        auto g4 = _mm_loadu_si128(reinterpret_cast<__m128i const *>(begin + i + 20));
+        // NB: holds the groups 5, 6 and 7
+        auto g567 = _mm_loadu_si128(reinterpret_cast<__m128i const *>(begin + i + 24));
+
+        // packus interleaves 128-bit lanes, so the groups are paired as (0, 2), (1, 3), (4, 6), (5, 7)
+        auto g02 = encode_impl_b32_group_avx2(g0, g2, ctl);
+        auto g13 = encode_impl_b32_group_avx2(g1, g3, ctl);
+        auto g46 = encode_impl_b32_group_avx2(g4, g567, ctl_g6);
+        auto g57 = encode_impl_b32_group_avx2(g567, g567, ctl_g5_g7);
+
+        auto out0 = encode_impl_b32_lookup_avx2(_mm256_packus_epi16(g02, g13), alphabet_lo, alphabet_hi);
+        auto out1 = encode_impl_b32_lookup_avx2(_mm256_packus_epi16(g46, g57), alphabet_lo, alphabet_hi);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(first), out0);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(first + 32), out1);
+    }
+
+    return i;
+}
+
+// 16 bytes -> 32 chars per iteration, returns the number of bytes consumed
+// the nibbles index the first 16 chars of the alphabet with pshufb
+BIZWEN_RFC4648_TARGET_SSSE3 inline std::size_t encode_impl_b16_ssse3(char8_t const *alphabet,
+                                                                     unsigned char const *begin, std::size_t len,
+                                                                     unsigned char *first) noexcept
+{
+    auto const lut = _mm_loadu_si128(reinterpret_cast<__m128i const *>(alphabet));
+    auto const mask = _mm_set1_epi8(15);
+
+    std::size_t i{};
+
+    for (; len - i >= 16; i += 16, first += 32)
+    {
+        auto in = _mm_loadu_si128(reinterpret_cast<__m128i const *>(begin + i));
+        auto hi = _mm_shuffle_epi8(lut, _mm_and_si128(_mm_srli_epi16(in, 4), mask));
+        auto lo = _mm_shuffle_epi8(lut, _mm_and_si128(in, mask));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(first), _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(first + 16), _mm_unpackhi_epi8(hi, lo));
+    }
+
+    return i;
+}
+
+// 32 bytes -> 64 chars per iteration, returns the number of bytes consumed
+BIZWEN_RFC4648_TARGET_AVX2 inline std::size_t encode_impl_b16_avx2(char8_t const *alphabet, unsigned char const *begin,
+                                                                   std::size_t len, unsigned char *first) noexcept
+{
+    auto const lut = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<__m128i const *>(alphabet)));
+    auto const mask = _mm256_set1_epi8(15);
+
+    std::size_t i{};
+
+    for (; len - i >= 32; i += 32, first += 64)
+    {
+        auto in = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(begin + i));
+        auto hi = _mm256_shuffle_epi8(lut, _mm256_and_si256(_mm256_srli_epi16(in, 4), mask));
+        auto lo = _mm256_shuffle_epi8(lut, _mm256_and_si256(in, mask));
+        // NB: unpack works within 128-bit lanes
+        auto a = _mm256_unpacklo_epi8(hi, lo);
+        auto b = _mm256_unpackhi_epi8(hi, lo);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(first), _mm256_permute2x128_si256(a, b, 0x20));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(first + 32), _mm256_permute2x128_si256(a, b, 0x31));
+    }
+
+    return i;
+}
+
+// zero-extend len chars to 16 or 32-bit units, 16 at a time
+template <typename C>
+BIZWEN_RFC4648_TARGET_SSSE3 inline void widen_ssse3(unsigned char const *in, std::size_t len, C *out) noexcept
+{
+    auto const zero = _mm_setzero_si128();
+    std::size_t i{};
+
+    for (; len - i >= 16; i += 16)
+    {
+        auto chars = _mm_loadu_si128(reinterpret_cast<__m128i const *>(in + i));
+        auto p = reinterpret_cast<__m128i *>(out + i);
+        auto lo = _mm_unpacklo_epi8(chars, zero);
+        auto hi = _mm_unpackhi_epi8(chars, zero);
+
+        if constexpr (sizeof(C) == 2)
+        {
+            _mm_storeu_si128(p, lo);
+            _mm_storeu_si128(p + 1, hi);
+        }
+        else
+        {
+            _mm_storeu_si128(p, _mm_unpacklo_epi16(lo, zero));
+            _mm_storeu_si128(p + 1, _mm_unpackhi_epi16(lo, zero));
+            _mm_storeu_si128(p + 2, _mm_unpacklo_epi16(hi, zero));
+            _mm_storeu_si128(p + 3, _mm_unpackhi_epi16(hi, zero));
+        }
+    }
+
+    for (; i != len; ++i)
+        out[i] = static_cast<C>(in[i]);
+}
+
+// same as widen_ssse3 with vpmovzxbw and vpmovzxbd, 32 at a time
+template <typename C>
+BIZWEN_RFC4648_TARGET_AVX2 inline void widen_avx2(unsigned char const *in, std::size_t len, C *out) noexcept
+{
+    std::size_t i{};
+
+    for (; len - i >= 32; i += 32)
+    {
+        auto p = reinterpret_cast<__m256i *>(out + i);
+
+        if constexpr (sizeof(C) == 2)
+        {
+            for (std::size_t j{}; j != 2; ++j)
+            {
+                auto chars = _mm_loadu_si128(reinterpret_cast<__m128i const *>(in + i + 16 * j));
+
+                _mm256_storeu_si256(p + j, _mm256_cvtepu8_epi16(chars));
+            }
+        }
+        else
+        {
+            for (std::size_t j{}; j != 4; ++j)
+            {
+                auto chars = _mm_loadl_epi64(reinterpret_cast<__m128i const *>(in + i + 8 * j));
+
+                _mm256_storeu_si256(p + j, _mm256_cvtepu8_epi32(chars));
+            }
+        }
+    }
+
+    for (; i != len; ++i)
+        out[i] = static_cast<C>(in[i]);
+}
+
+// wide output is encoded to a stack block of this many chars first, which
+// stays in L1 until it is widened
+inline constexpr std::size_t widen_block_size = 2048;
+
+using encode_kernel = std::size_t (*)(char8_t const *, unsigned char const *, std::size_t, unsigned char *) noexcept;
+
+// resolved once per family, nullptr if there is no kernel for the CPU
+// the kernels return the number of bytes consumed, encoded_size() of it is written
+template <rfc4648_kind Family, bool Padding>
+inline encode_kernel get_encode_kernel() noexcept
+{
+    static encode_kernel const kernel = []() noexcept -> encode_kernel {
+        auto level = detail::get_simd_level();
+
+        if constexpr (Family == rfc4648_kind::base64)
+        {
+            if (level >= detail::simd_level::avx512vbmi)
+                return encode_impl_b64_avx512vbmi<Padding>;
+            if (level >= detail::simd_level::avx2)
+                return encode_impl_b64_avx2;
+        }
+        else if constexpr (Family == rfc4648_kind::base32)
+        {
+            if (level >= detail::simd_level::avx2)
+                return encode_impl_b32_avx2;
+        }
+        else
+        {
+            if (level >= detail::simd_level::avx2)
+                return encode_impl_b16_avx2;
+            if (level >= detail::simd_level::ssse3)
+                return encode_impl_b16_ssse3;
+        }
+
+        return nullptr;
+    }();
+
+    return kernel;
+}
+
+// inputs shorter than this are left to the scalar code, the kernels consume
+// nothing below their step and the masked AVX-512 kernel costs more than a few
+// scalar quanta, so tiny inputs such as UUIDs skip the call
+template <rfc4648_kind Family>
+inline std::size_t get_encode_kernel_min() noexcept
+{
+    static std::size_t const min = []() noexcept -> std::size_t {
+        auto level = detail::get_simd_level();
+
+        if constexpr (Family == rfc4648_kind::base64)
+            return level >= detail::simd_level::avx512vbmi ? 12 : 24;
+        else if constexpr (Family == rfc4648_kind::base32)
+            return 40;
+        else
+            return level >= detail::simd_level::avx2 ? 32 : 16;
+    }();
+
+    return min;
+}
+
+// bytes that every kernel of the family consumes whole
+template <rfc4648_kind Family>
+inline constexpr std::size_t tail_block_bytes = Family == rfc4648_kind::base64   ? 24
+                                                : Family == rfc4648_kind::base32 ? 40
+                                                                                 : 32;
+
+// encode the len < tail_block_bytes bytes left by a kernel with the same kernel
+// on a zero filled copy, the zero bytes only reach the chars that are cut off
+template <rfc4648_kind Family, bool Padding>
+inline unsigned char *encode_impl_tail(encode_kernel kernel, char8_t const *alphabet, unsigned char const *begin,
+                                       std::size_t len, unsigned char *first) noexcept
+{
+    constexpr auto block = tail_block_bytes<Family>;
+
+    unsigned char in[block]{};
+    unsigned char out[detail::encoded_size<Family, false>(block)];
+
+    std::memcpy(in, begin, len);
+    kernel(alphabet, in, block, out);
+
+    auto chars = detail::encoded_size<Family, false>(len);
+
+    std::memcpy(first, out, chars);
+    first += chars;
+
+    if constexpr (Padding && Family != rfc4648_kind::base16)
+    {
+        auto padded = detail::encoded_size<Family, true>(len);
+
+        std::memset(first, alphabet[Family == rfc4648_kind::base64 ? 64 : 32], padded - chars);
+        first += padded - chars;
+    }
+
+    return first;
+}
+
+// encode one message of a batch, kernel is resolved once per batch
+template <rfc4648_kind Kind, bool Padding>
+inline unsigned char *encode_impl_batch_item(encode_kernel kernel, unsigned char const *begin, std::size_t len,
+                                             unsigned char *first) noexcept
+{
+    constexpr auto family = detail::get_family<Kind>();
+    constexpr auto alphabet = get_alphabet<Kind>();
+
+    auto n = kernel(alphabet, begin, len, first);
+
+    first += detail::encoded_size<family, Padding>(n);
+
+    if (n == len)
+        return first;
+
+    return encode_impl_tail<family, Padding>(kernel, alphabet, begin + n, len - n, first);
+}
+#endif
+
+// hand the bulk of the input to the vector kernel when the output is contiguous
+// NB: 16 and 32-bit output is encoded to a stack block first and widened
+template <rfc4648_kind Family, bool Padding, typename A, typename I, typename O>
+inline constexpr void encode_impl_simd([[maybe_unused]] A alphabet, [[maybe_unused]] I &begin, [[maybe_unused]] I end,
+                                      [[maybe_unused]] O &first)
+{
+#if defined(BIZWEN_RFC4648_HAS_SIMD)
+    if constexpr (detail::narrow_contiguous_iterator<O>)
+    {
+#if defined(__cpp_if_consteval) && (__cpp_if_consteval >= 202106L)
+        if !consteval
+#else
+        if (!::std::is_constant_evaluated())
+#endif
+        {
+            auto kernel = get_encode_kernel<Family, Padding>();
+
+            if (kernel && static_cast<std::size_t>(end - begin) >= get_encode_kernel_min<Family>())
+            {
+                auto out_ptr = reinterpret_cast<unsigned char *>(std::to_address(first));
+                auto in_ptr = reinterpret_cast<unsigned char const *>(begin);
+                auto n = kernel(alphabet, in_ptr, end - begin, out_ptr);
+
+                begin += n;
+                first += detail::encoded_size<Family, Padding>(n);
+            }
+        }
+    }
+    else if constexpr (detail::wide_contiguous_iterator<O>)
+    {
+#if defined(__cpp_if_consteval) && (__cpp_if_consteval >= 202106L)
+        if !consteval
+#else
+        if (!::std::is_constant_evaluated())
+#endif
+        {
+            if (auto kernel = get_encode_kernel<Family, Padding>())
+            {
+                using char_type = std::iter_value_t<O>;
+
+                // whole quanta that fill the block
+                constexpr auto block_bytes = widen_block_size / detail::quantum_chars<Family> *
+                                             detail::quantum_bytes<Family>;
+
+                auto widen = detail::get_simd_level() >= detail::simd_level::avx2 ? widen_avx2<char_type>
+                                                                                   : widen_ssse3<char_type>;
+                unsigned char buf[widen_block_size];
+
+                // NB: a kernel leaves the tail of a block that is shorter than its
+                // step, which is encoded again with the next block
+                while (end - begin >= 64)
+                {
+                    auto len = std::min(static_cast<std::size_t>(end - begin), block_bytes);
+                    auto in_ptr = reinterpret_cast<unsigned char const *>(begin);
+                    auto n = kernel(alphabet, in_ptr, len, buf);
+
+                    if (!n)
+                        break;
+
+                    auto chars = detail::encoded_size<Family, Padding>(n);
+
+                    widen(buf, chars, std::to_address(first));
+                    begin += n;
+                    first += chars;
+                }
+            }
+        }
+    }
+#endif
+}
+
+// write the Count chars of an incomplete quantum and, if Padding, the padding
+// that completes it as one block, so the padding is not a run of single stores
+template <bool Padding, std::size_t Quantum, std::size_t Count, typename O>
+inline constexpr void write_tail(char8_t const (&chars)[Count], char8_t pad, O &first)
+{
+    if constexpr (Padding)
+    {
+        // NB: an initializer, not a loop, so the block is built in a register
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+            char8_t block[]{(I < Count ? chars[I < Count ? I : 0] : pad)...};
+
+            detail::write_block(block, first);
+        }(std::make_index_sequence<Quantum>{});
+    }
+    else
+    {
+        detail::write_block(chars, first);
     }
 }
 
@@ -103,22 +650,11 @@ inline constexpr void encode_impl_b64_6(A alphabet, I begin, O &first)
 {
     auto data = chars_to_int_big_endian<6>(begin);
 
-    *first = alphabet[(data >> 58) & 63];
-    ++first;
-    *first = alphabet[(data >> 52) & 63];
-    ++first;
-    *first = alphabet[(data >> 46) & 63];
-    ++first;
-    *first = alphabet[(data >> 40) & 63];
-    ++first;
-    *first = alphabet[(data >> 34) & 63];
-    ++first;
-    *first = alphabet[(data >> 28) & 63];
-    ++first;
-    *first = alphabet[(data >> 22) & 63];
-    ++first;
-    *first = alphabet[(data >> 16) & 63];
-    ++first;
+    char8_t chars[]{alphabet[(data >> 58) & 63], alphabet[(data >> 52) & 63], alphabet[(data >> 46) & 63],
+                    alphabet[(data >> 40) & 63], alphabet[(data >> 34) & 63], alphabet[(data >> 28) & 63],
+                    alphabet[(data >> 22) & 63], alphabet[(data >> 16) & 63]};
+
+    detail::write_block(chars, first);
 }
 
 template <typename A, typename I, typename O>
@@ -126,14 +662,10 @@ inline constexpr void encode_impl_b64_3(A alphabet, I begin, O &first)
 {
     auto data = chars_to_int_big_endian<3>(begin);
 
-    *first = alphabet[(data >> 26) & 63];
-    ++first;
-    *first = alphabet[(data >> 20) & 63];
-    ++first;
-    *first = alphabet[(data >> 14) & 63];
-    ++first;
-    *first = alphabet[(data >> 8) & 63];
-    ++first;
+    char8_t chars[]{alphabet[(data >> 26) & 63], alphabet[(data >> 20) & 63], alphabet[(data >> 14) & 63],
+                    alphabet[(data >> 8) & 63]};
+
+    detail::write_block(chars, first);
 }
 
 template <bool Padding, typename A, typename I, typename O>
@@ -141,17 +673,9 @@ inline constexpr void encode_impl_b64_2(A alphabet, I begin, O &first)
 {
     auto data = chars_to_int_big_endian<2>(begin);
 
-    *first = alphabet[(data >> 26) & 63];
-    ++first;
-    *first = alphabet[(data >> 20) & 63];
-    ++first;
-    *first = alphabet[(data >> 14) & 63];
+    char8_t chars[]{alphabet[(data >> 26) & 63], alphabet[(data >> 20) & 63], alphabet[(data >> 14) & 63]};
 
-    if constexpr (Padding)
-    {
-        *first = alphabet[64];
-        ++first;
-    }
+    write_tail<Padding, 4>(chars, alphabet[64], first);
 }
 
 template <bool Padding, typename A, typename I, typename O>
@@ -161,31 +685,108 @@ inline constexpr void encode_impl_b64_1(A alphabet, I begin, O &first)
     auto b = a >> 2;        // XXXXXX
     auto c = (a << 4) & 63; // XX0000
 
-    *first = alphabet[b];
-    ++first;
-    *first = alphabet[c];
-    ++first;
+    char8_t chars[]{alphabet[b], alphabet[c]};
 
-    if constexpr (Padding)
+    write_tail<Padding, 4>(chars, alphabet[64], first);
+}
+
+// pair_table[v] is the two chars encoding the 12 bits v
+template <rfc4648_kind Kind>
+inline consteval auto get_b64_pair_table() noexcept
+{
+    auto alphabet = get_alphabet<Kind>();
+    std::array<std::array<char8_t, 2>, 4096> table{};
+
+    for (std::size_t i{}; i != 4096; ++i)
+        table[i] = {alphabet[i >> 6], alphabet[i & 63]};
+
+    return table;
+}
+
+template <rfc4648_kind Kind>
+inline constexpr auto b64_pair_table = get_b64_pair_table<Kind>();
+
+// define BIZWEN_RFC4648_B64_PAIR_TABLE to make the scalar base64 encoder look
+// up two chars at a time, this costs 8 KiB of table per alphabet
+#if defined(BIZWEN_RFC4648_B64_PAIR_TABLE)
+inline constexpr bool b64_pair_table_default = true;
+#else
+inline constexpr bool b64_pair_table_default = false;
+#endif
+
+template <rfc4648_kind Kind, typename O>
+inline constexpr void encode_impl_b64_pair(std::size_t bits, O &first)
+{
+    auto &pair = b64_pair_table<Kind>[bits & 4095];
+
+    if constexpr (detail::narrow_contiguous_iterator<O>)
     {
-        *first = alphabet[64]; // pad1
-        ++first;
-        *first = alphabet[64]; // pad2
-        ++first;
+#if defined(__cpp_if_consteval) && (__cpp_if_consteval >= 202106L)
+        if !consteval
+#else
+        if (!::std::is_constant_evaluated())
+#endif
+        {
+            // one 16-bit store
+            std::memcpy(std::to_address(first), pair.data(), 2);
+            first += 2;
+
+            return;
+        }
     }
+
+    *first = pair[0];
+    ++first;
+    *first = pair[1];
+    ++first;
 }
 
-template <bool Padding, typename A, typename I, typename O>
-inline constexpr void encode_impl_b64(A alphabet, I begin, I end, O &first)
+template <rfc4648_kind Kind, typename I, typename O>
+inline constexpr void encode_impl_b64_6_pair(I begin, O &first)
 {
-    if constexpr (sizeof(std::size_t) == 8)
+    auto data = chars_to_int_big_endian<6>(begin);
+
+    encode_impl_b64_pair<Kind>(data >> 52, first);
+    encode_impl_b64_pair<Kind>(data >> 40, first);
+    encode_impl_b64_pair<Kind>(data >> 28, first);
+    encode_impl_b64_pair<Kind>(data >> 16, first);
+}
+
+template <rfc4648_kind Kind, typename I, typename O>
+inline constexpr void encode_impl_b64_3_pair(I begin, O &first)
+{
+    auto data = chars_to_int_big_endian<3>(begin);
+
+    encode_impl_b64_pair<Kind>(data >> 20, first);
+    encode_impl_b64_pair<Kind>(data >> 8, first);
+}
+
+template <rfc4648_kind Kind, bool Padding, bool PairTable = b64_pair_table_default, typename A, typename I,
+          typename O>
+inline constexpr void encode_impl_b64_scalar(A alphabet, I begin, I end, O &first)
+{
+    if constexpr (PairTable)
     {
-        for (; end - begin > 5; begin += 6)
-            encode_impl_b64_6(alphabet, begin, first);
+        if constexpr (sizeof(std::size_t) == 8)
+        {
+            for (; end - begin > 5; begin += 6)
+                encode_impl_b64_6_pair<Kind>(begin, first);
+        }
+
+        for (; end - begin > 2; begin += 3)
+            encode_impl_b64_3_pair<Kind>(begin, first);
     }
+    else
+    {
+        if constexpr (sizeof(std::size_t) == 8)
+        {
+            for (; end - begin > 5; begin += 6)
+                encode_impl_b64_6(alphabet, begin, first);
+        }
 
-    for (; end - begin > 2; begin += 3)
-        encode_impl_b64_3(alphabet, begin, first);
+        for (; end - begin > 2; begin += 3)
+            encode_impl_b64_3(alphabet, begin, first);
+    }
 
     if (end - begin == 2)
         encode_impl_b64_2<Padding>(alphabet, begin, first);
@@ -195,71 +796,56 @@ inline constexpr void encode_impl_b64(A alphabet, I begin, I end, O &first)
     // == 0  fallthrough
 }
 
+template <rfc4648_kind Kind, bool Padding, typename A, typename I, typename O>
+inline constexpr void encode_impl_b64(A alphabet, I begin, I end, O &first)
+{
+    encode_impl_simd<rfc4648_kind::base64, Padding>(alphabet, begin, end, first);
+    encode_impl_b64_scalar<Kind, Padding>(alphabet, begin, end, first);
+}
+
 template <typename A, typename I, typename O>
 inline constexpr void encode_impl_b64_ctx(A alphabet, detail::buf_ref buf, detail::sig_ref sig, I begin, I end, O &first)
 {
-    if (sig == 2) // 0, 1, 2
-    {
-        if (end - begin == 0)
-            return;
-
-        unsigned char buf[3];
+#if __has_cpp_attribute(assume)
+    [[assume(sig < 3)]];
+    [[assume(end - begin >= 0)]];
+#endif
 
-        buf[0] = buf[0];
-        buf[1] = buf[1];
-        buf[2] = to_uc(*(begin++));
+    if (end - begin + sig < 3)
+    {
+        for (; begin != end; ++begin, ++sig)
+            buf[sig] = to_uc(*begin);
 
-        encode_impl_b64_3(alphabet, std::begin(buf), first);
+        return;
     }
-    else if (sig) // == 1
-    {
-        if (end - begin == 0)
-        {
-            return;
-        }
-        else if (end - begin == 1)
-        {
-            buf[1] = to_uc(*(begin++));
-            sig = 2;
 
-            return;
-        }
-        else // >= 2
-        {
-            unsigned char lbuf[3];
+    if (sig)
+    {
+        unsigned char lbuf[3];
 
-            lbuf[0] = buf[0];
-            lbuf[1] = to_uc(*(begin++));
-            lbuf[2] = to_uc(*(begin++));
+        std::copy(std::begin(buf), std::begin(buf) + sig, std::begin(lbuf));
+        for (auto i = sig; i != 3; ++i, ++begin)
+            lbuf[i] = to_uc(*begin);
 
-            encode_impl_b64_3(alphabet, std::begin(lbuf), first);
-        }
+        encode_impl_b64_3(alphabet, std::begin(lbuf), first);
     }
 
+    // NB: only whole quanta go to the vector kernel, the rest is kept in buf
+    encode_impl_simd<rfc4648_kind::base64, false>(alphabet, begin, begin + (end - begin) / 3 * 3, first);
+
     if constexpr (sizeof(std::size_t) == 8)
     {
         for (; end - begin > 5; begin += 6)
             encode_impl_b64_6(alphabet, begin, first);
     }
 
-    for (; end - begin > 3; begin += 3)
+    for (; end - begin > 2; begin += 3)
         encode_impl_b64_3(alphabet, begin, first);
 
-    if (end - begin == 2)
-    {
-        buf[0] = to_uc(*(begin++));
-        buf[1] = to_uc(*(begin));
-        sig = 2;
-    }
-    else if (end - begin != 0) // == 1
-    {
-        buf[1] = to_uc(*(begin));
-        sig = 1;
-    }
-    else // NB: clear ctx
-    {
-        sig = 0;
-    }
+    sig = static_cast<unsigned char>(end - begin);
+
+    for (std::size_t i{}; i != sig; ++i, ++begin)
+        buf[i] = to_uc(*begin);
 }
 
 template <bool Padding, typename A, typename O>
@@ -280,22 +866,11 @@ inline constexpr void encode_impl_b32_5(A alphabet, I begin, O &first)
 {
     auto data = chars_to_int_big_endian<5>(begin);
 
-    *first = alphabet[(data >> 59) & 31];
-    ++first;
-    *first = alphabet[(data >> 54) & 31];
-    ++first;
-    *first = alphabet[(data >> 49) & 31];
-    ++first;
-    *first = alphabet[(data >> 44) & 31];
-    ++first;
-    *first = alphabet[(data >> 39) & 31];
-    ++first;
-    *first = alphabet[(data >> 34) & 31];
-    ++first;
-    *first = alphabet[(data >> 29) & 31];
-    ++first;
-    *first = alphabet[(data >> 24) & 31];
-    ++first;
+    char8_t chars[]{alphabet[(data >> 59) & 31], alphabet[(data >> 54) & 31], alphabet[(data >> 49) & 31],
+                    alphabet[(data >> 44) & 31], alphabet[(data >> 39) & 31], alphabet[(data >> 34) & 31],
+                    alphabet[(data >> 29) & 31], alphabet[(data >> 24) & 31]};
+
+    detail::write_block(chars, first);
 }
 
 template <bool Padding, typename A, typename I, typename O>
@@ -303,27 +878,12 @@ inline constexpr void encode_impl_b32_4(A alphabet, I begin, O &first)
 {
     auto data = chars_to_int_big_endian<4>(begin);
 
-    *first = alphabet[(data >> 27) & 31];
-    ++first;
-    *first = alphabet[(data >> 22) & 31];
-    ++first;
-    *first = alphabet[(data >> 17) & 31];
-    ++first;
-    *first = alphabet[(data >> 12) & 31];
-    ++first;
-    *first = alphabet[(data >> 7) & 31];
-    ++first;
-    *first = alphabet[(data >> 2) & 31];
-    ++first;
     // NB: left shift
-    *first = alphabet[(data << 3) & 31];
-    ++first;
+    char8_t chars[]{alphabet[(data >> 27) & 31], alphabet[(data >> 22) & 31], alphabet[(data >> 17) & 31],
+                    alphabet[(data >> 12) & 31], alphabet[(data >> 7) & 31],  alphabet[(data >> 2) & 31],
+                    alphabet[(data << 3) & 31]};
 
-    if constexpr (Padding)
-    {
-        *first = alphabet[32];
-        ++first;
-    }
+    write_tail<Padding, 8>(chars, alphabet[32], first);
 }
 
 template <bool Padding, typename A, typename I, typename O>
@@ -331,26 +891,10 @@ inline constexpr void encode_impl_b32_3(A alphabet, I begin, O &first)
 {
     auto data = chars_to_int_big_endian<3>(begin);
 
-    *first = alphabet[(data >> 27) & 31];
-    ++first;
-    *first = alphabet[(data >> 22) & 31];
-    ++first;
-    *first = alphabet[(data >> 17) & 31];
-    ++first;
-    *first = alphabet[(data >> 12) & 31];
-    ++first;
-    *first = alphabet[(data >> 7) & 31];
-    ++first;
+    char8_t chars[]{alphabet[(data >> 27) & 31], alphabet[(data >> 22) & 31], alphabet[(data >> 17) & 31],
+                    alphabet[(data >> 12) & 31], alphabet[(data >> 7) & 31]};
 
-    if constexpr (Padding)
-    {
-        *first = alphabet[32];
-        ++first;
-        *first = alphabet[32];
-        ++first;
-        *first = alphabet[32];
-        ++first;
-    }
+    write_tail<Padding, 8>(chars, alphabet[32], first);
 }
 
 template <bool Padding, typename A, typename I, typename O>
@@ -358,81 +902,297 @@ inline constexpr void encode_impl_b32_2(A alphabet, I begin, O &first)
 {
     auto data = chars_to_int_big_endian<2>(begin);
 
-    *first = alphabet[(data >> 27) & 31];
-    ++first;
-    *first = alphabet[(data >> 22) & 31];
-    ++first;
-    *first = alphabet[(data >> 17) & 31];
-    ++first;
-    *first = alphabet[(data >> 12) & 31];
-    ++first;
+    char8_t chars[]{alphabet[(data >> 27) & 31], alphabet[(data >> 22) & 31], alphabet[(data >> 17) & 31],
+                    alphabet[(data >> 12) & 31]};
 
-    if constexpr (Padding)
+    write_tail<Padding, 8>(chars, alphabet[32], first);
+}
+
+template <bool Padding, typename A, typename I, typename O>
+inline constexpr void encode_impl_b32_1(A alphabet, I begin, O &first)
+{
+    auto a = to_uc(*(begin));
+
+    char8_t chars[]{alphabet[a >> 3], alphabet[(a << 2) & 31]};
+
+    write_tail<Padding, 8>(chars, alphabet[32], first);
+}
+
+template <bool Padding = true, typename A, typename I, typename O>
+inline constexpr void encode_impl_b32(A alphabet, I begin, I end, O &first)
+{
+    encode_impl_simd<rfc4648_kind::base32, Padding>(alphabet, begin, end, first);
+
+    for (; end - begin > 4; begin += 5)
+        encode_impl_b32_5(alphabet, begin, first);
+
+    if (end - begin == 4)
+        encode_impl_b32_4<Padding>(alphabet, begin, first);
+    else if (end - begin == 3)
+        encode_impl_b32_3<Padding>(alphabet, begin, first);
+    else if (end - begin == 2)
+        encode_impl_b32_2<Padding>(alphabet, begin, first);
+    else if (end - begin) // == 1
+        encode_impl_b32_1<Padding>(alphabet, begin, first);
+    // == 0  fallthrough
+}
+
+template <typename A, typename I, typename O>
+inline constexpr void encode_impl_b32_ctx(A alphabet, detail::buf_ref buf, detail::sig_ref sig, I begin, I end, O &first)
+{
+#if __has_cpp_attribute(assume)
+    [[assume(sig < 5)]];
+    [[assume(end - begin >= 0)]];
+#endif
+
+    if (end - begin + sig < 5)
     {
-        *first = alphabet[32];
-        ++first;
-        *first = alphabet[32];
+        for (; begin != end; ++begin, ++sig)
+            buf[sig] = to_uc(*begin);
+
+        return;
+    }
+
+    if (sig)
+    {
+        unsigned char lbuf[5];
+
+        std::copy(std::begin(buf), std::begin(buf) + sig, std::begin(lbuf));
+        for (auto i = sig; i != 5; ++i, ++begin)
+            lbuf[i] = to_uc(*begin);
+
+        encode_impl_b32_5(alphabet, std::begin(lbuf), first);
+    }
+
+    // NB: only whole quanta go to the vector kernel, the rest is kept in buf
+    encode_impl_simd<rfc4648_kind::base32, false>(alphabet, begin, begin + (end - begin) / 5 * 5, first);
+
+    for (; end - begin > 4; begin += 5)
+        encode_impl_b32_5(alphabet, begin, first);
+
+    sig = static_cast<unsigned char>(end - begin);
+
+    for (std::size_t i{}; i != sig; ++i, ++begin)
+        buf[i] = to_uc(*begin);
+}
+
+template <bool Padding, typename A, typename O>
+inline constexpr void encode_impl_b32_ctx(A alphabet, detail::buf_ref buf, detail::sig_ref sig, O &first)
+{
+    if (sig == 1)
+        encode_impl_b32_1<Padding>(alphabet, std::begin(buf), first);
+    else if (sig == 2)
+        encode_impl_b32_2<Padding>(alphabet, std::begin(buf), first);
+    else if (sig == 3)
+        encode_impl_b32_3<Padding>(alphabet, std::begin(buf), first);
+    else if (sig == 4)
+        encode_impl_b32_4<Padding>(alphabet, std::begin(buf), first);
+
+    sig = 0;
+}
+
+// encode Count bytes, at most 4, to 2 * Count chars
+template <std::size_t Count, typename A, typename I, typename O>
+inline constexpr void encode_impl_b16_n(A alphabet, I begin, O &first)
+{
+    auto data = chars_to_int_big_endian<Count>(begin);
+
+    [&]<std::size_t... J>(std::index_sequence<J...>) {
+        char8_t chars[]{alphabet[(data >> (28 - J * 4)) & 15]...};
+
+        detail::write_block(chars, first);
+    }(std::make_index_sequence<Count * 2>{});
+}
+
+template <typename A, typename I, typename O>
+inline constexpr void encode_impl_b16(A alphabet, I begin, I end, O &first)
+{
+    encode_impl_simd<rfc4648_kind::base16, false>(alphabet, begin, end, first);
+
+    for (; end - begin > 3; begin += 4)
+        encode_impl_b16_n<4>(alphabet, begin, first);
+
+    for (; begin != end; ++begin)
+    {
+        auto data = to_uc(*begin);
+
+        *first = alphabet[data >> 4];
         ++first;
-        *first = alphabet[32];
+        *first = alphabet[data & 15];
         ++first;
-        *first = alphabet[32];
+    }
+}
+
+template <rfc4648_kind Kind, bool Padding, typename I, typename O>
+inline constexpr void encode_impl_any(I begin, I end, O &first)
+{
+    if constexpr (detail::get_family<Kind>() == rfc4648_kind::base64)
+        encode_impl_b64<Kind, Padding>(get_alphabet<Kind>(), begin, end, first);
+    else if constexpr (detail::get_family<Kind>() == rfc4648_kind::base32)
+        encode_impl_b32<Padding>(get_alphabet<Kind>(), begin, end, first);
+    else
+        encode_impl_b16(get_alphabet<Kind>(), begin, end, first);
+}
+
+// encode exactly N bytes, the quanta are unrolled and the incomplete one is
+// selected at compile time, so no length is tested and no kernel is called
+template <rfc4648_kind Kind, bool Padding, std::size_t N, typename I>
+inline constexpr auto encode_impl_fixed(I begin)
+{
+    constexpr auto alphabet = get_alphabet<Kind>();
+
+    std::array<char, detail::encoded_size<Kind, Padding>(N)> chars;
+    auto first = chars.data();
+
+#if defined(BIZWEN_RFC4648_HAS_SIMD)
+    // NB: no kernel takes fewer than 12 bytes, from the step of the selected
+    // kernel on it is faster than the unrolled code
+    if constexpr (N >= 12)
+    {
+#if defined(__cpp_if_consteval) && (__cpp_if_consteval >= 202106L)
+        if !consteval
+#else
+        if (!::std::is_constant_evaluated())
+#endif
+        {
+            constexpr auto family = detail::get_family<Kind>();
+
+            if (get_encode_kernel<family, Padding>() && N >= get_encode_kernel_min<family>())
+            {
+                encode_impl_any<Kind, Padding>(begin, begin + N, first);
+
+                return chars;
+            }
+        }
+    }
+#endif
+
+    if constexpr (detail::get_family<Kind>() == rfc4648_kind::base64)
+    {
+        constexpr std::size_t pairs = sizeof(std::size_t) == 8 ? N / 6 : 0;
+
+        detail::unroll<pairs>([&](auto i) { encode_impl_b64_6(alphabet, begin + i * 6, first); });
+        detail::unroll<N / 3 - pairs * 2>(
+            [&](auto i) { encode_impl_b64_3(alphabet, begin + pairs * 6 + i * 3, first); });
+
+        if constexpr (N % 3 == 2)
+            encode_impl_b64_2<Padding>(alphabet, begin + N / 3 * 3, first);
+        else if constexpr (N % 3 == 1)
+            encode_impl_b64_1<Padding>(alphabet, begin + N / 3 * 3, first);
+    }
+    else if constexpr (detail::get_family<Kind>() == rfc4648_kind::base32)
+    {
+        detail::unroll<N / 5>([&](auto i) { encode_impl_b32_5(alphabet, begin + i * 5, first); });
+
+        if constexpr (N % 5 == 4)
+            encode_impl_b32_4<Padding>(alphabet, begin + N / 5 * 5, first);
+        else if constexpr (N % 5 == 3)
+            encode_impl_b32_3<Padding>(alphabet, begin + N / 5 * 5, first);
+        else if constexpr (N % 5 == 2)
+            encode_impl_b32_2<Padding>(alphabet, begin + N / 5 * 5, first);
+        else if constexpr (N % 5 == 1)
+            encode_impl_b32_1<Padding>(alphabet, begin + N / 5 * 5, first);
+    }
+    else
+    {
+        detail::unroll<N / 4>([&](auto i) { encode_impl_b16_n<4>(alphabet, begin + i * 4, first); });
+
+        if constexpr (N % 4)
+            encode_impl_b16_n<N % 4>(alphabet, begin + N / 4 * 4, first);
+    }
+
+    return chars;
+}
+
+// write the chars one by one, the separator goes before a char that would
+// exceed the line
+template <typename O>
+inline constexpr void write_wrapped(unsigned char const *chars, std::size_t n, std::size_t line,
+                                    std::string_view separator, std::size_t &col, O &first)
+{
+    for (std::size_t i{}; i != n; ++i)
+    {
+        if (col == line)
+        {
+            for (auto c : separator)
+            {
+                *first = c;
+                ++first;
+            }
+
+            col = 0;
+        }
+
+        *first = chars[i];
         ++first;
+        ++col;
     }
 }
 
-template <bool Padding, typename A, typename I, typename O>
-inline constexpr void encode_impl_b32_1(A alphabet, I begin, O &first)
+// encode the whole quanta of [begin, end), the quanta that fit on the current
+// line are handed to the one-shot encoder together, only a quantum split by the
+// end of a line is written char by char, returns the end of the whole quanta
+template <rfc4648_kind Kind, typename I, typename O>
+inline constexpr I encode_impl_wrap(I begin, I end, O &first, std::size_t line, std::string_view separator,
+                                    std::size_t &col)
 {
-    auto a = to_uc(*(begin));
+    constexpr auto bytes = detail::quantum_bytes<Kind>;
+    constexpr auto chars = detail::quantum_chars<Kind>;
 
-    *first = alphabet[a >> 3];
-    ++first;
-    *first = alphabet[(a << 2) & 31];
-    ++first;
+    while (static_cast<std::size_t>(end - begin) >= bytes)
+    {
+        if (col == line)
+        {
+            for (auto c : separator)
+            {
+                *first = c;
+                ++first;
+            }
+
+            col = 0;
+        }
+
+        auto quanta = std::min((line - col) / chars, static_cast<std::size_t>(end - begin) / bytes);
+
+        if (quanta)
+        {
+            encode_impl_any<Kind, true>(begin, begin + quanta * bytes, first);
+            begin += quanta * bytes;
+            col += quanta * chars;
+        }
+        else
+        {
+            unsigned char tmp[chars];
+            auto tmp_first = std::begin(tmp);
 
-    if constexpr (Padding)
-    {
-        *first = alphabet[32];
-        ++first;
-        *first = alphabet[32];
-        ++first;
-        *first = alphabet[32];
-        ++first;
-        *first = alphabet[32];
-        ++first;
-        *first = alphabet[32];
-        ++first;
-        *first = alphabet[32];
-        ++first;
+            encode_impl_any<Kind, true>(begin, begin + bytes, tmp_first);
+            begin += bytes;
+            write_wrapped(std::begin(tmp), chars, line, separator, col, first);
+        }
     }
+
+    return begin;
 }
 
-template <bool Padding = true, typename A, typename I, typename O>
-inline constexpr void encode_impl_b32(A alphabet, I begin, I end, O &first)
+// the incomplete quantum at the end
+template <rfc4648_kind Kind, bool Padding, typename I, typename O>
+inline constexpr void encode_impl_wrap_tail(I begin, I end, O &first, std::size_t line, std::string_view separator,
+                                            std::size_t &col)
 {
-    for (; end - begin > 4; begin += 5)
-        encode_impl_b32_5(alphabet, begin, first);
+    unsigned char tmp[detail::quantum_chars<Kind>];
+    auto tmp_first = std::begin(tmp);
 
-    if (end - begin == 4)
-        encode_impl_b32_4<Padding>(alphabet, begin, first);
-    else if (end - begin == 3)
-        encode_impl_b32_3<Padding>(alphabet, begin, first);
-    else if (end - begin == 2)
-        encode_impl_b32_2<Padding>(alphabet, begin, first);
-    else if (end - begin) // == 1
-        encode_impl_b32_1<Padding>(alphabet, begin, first);
-    // == 0  fallthrough
+    encode_impl_any<Kind, Padding>(begin, end, tmp_first);
+    write_wrapped(std::begin(tmp), static_cast<std::size_t>(tmp_first - std::begin(tmp)), line, separator, col, first);
 }
 
-template <typename A, typename I, typename O>
-inline constexpr void encode_impl_b32_ctx(A alphabet, detail::buf_ref buf, detail::sig_ref sig, I begin, I end, O &first)
+template <rfc4648_kind Kind, typename I, typename O>
+inline constexpr void encode_impl_wrap_ctx(detail::buf_ref buf, detail::sig_ref sig, std::size_t &col, I begin, I end,
+                                           O &first, std::size_t line, std::string_view separator)
 {
-#if __has_cpp_attribute(assume)
-    [[assume(sig < 5)]];
-    [[assume(end - begin >= 0)]];
-#endif
+    constexpr auto bytes = detail::quantum_bytes<Kind>;
 
-    if (end - begin + sig < 5)
+    if (static_cast<std::size_t>(end - begin) + sig < bytes)
     {
         for (; begin != end; ++begin, ++sig)
             buf[sig] = to_uc(*begin);
@@ -442,72 +1202,44 @@ inline constexpr void encode_impl_b32_ctx(A alphabet, detail::buf_ref buf, detai
 
     if (sig)
     {
-        unsigned char lbuf[5];
+        unsigned char lbuf[bytes];
 
         std::copy(std::begin(buf), std::begin(buf) + sig, std::begin(lbuf));
-        std::copy(begin, begin + (5 - sig), std::begin(lbuf) + sig);
-        begin += (5 - sig);
+        for (auto i = sig; i != bytes; ++i, ++begin)
+            lbuf[i] = to_uc(*begin);
 
-        encode_impl_b32_5(alphabet, std::begin(lbuf), first);
+        encode_impl_wrap<Kind>(std::begin(lbuf), std::end(lbuf), first, line, separator, col);
     }
 
-    for (; end - begin > 4; begin += 5)
-        encode_impl_b32_5(alphabet, begin, first);
-
+    begin = encode_impl_wrap<Kind>(begin, end, first, line, separator, col);
     sig = static_cast<unsigned char>(end - begin);
 
     for (std::size_t i{}; i != sig; ++i, ++begin)
         buf[i] = to_uc(*begin);
 }
 
-template <bool Padding, typename A, typename O>
-inline constexpr void encode_impl_b32_ctx(A alphabet, detail::buf_ref buf, detail::sig_ref sig, O &first)
+// split [begin, end) at quantum boundaries into one chunk per thread, each chunk
+// is encoded to its precomputed offset and only the last one is padded
+template <rfc4648_kind Kind, bool Padding, typename I, typename O>
+inline void encode_impl_parallel(std::size_t threads, I begin, I end, O &first)
 {
-    if (sig == 1)
-        encode_impl_b32_1<Padding>(alphabet, std::begin(buf), first);
-    else if (sig == 2)
-        encode_impl_b32_2<Padding>(alphabet, std::begin(buf), first);
-    else if (sig == 3)
-        encode_impl_b32_3<Padding>(alphabet, std::begin(buf), first);
-    else if (sig == 4)
-        encode_impl_b32_4<Padding>(alphabet, std::begin(buf), first);
-
-    sig = 0;
-}
+    using diff = std::iter_difference_t<O>;
 
-template <typename A, typename I, typename O>
-inline constexpr void encode_impl_b16(A alphabet, I begin, I end, O &first)
-{
-    if constexpr (sizeof(size_t) == 8)
-    {
-        for (; end - begin > 7; begin += 8)
-        {
-            auto data = chars_to_int_big_endian<8>(begin);
+    auto size = static_cast<std::size_t>(end - begin);
+    auto chunk = size / threads / detail::quantum_bytes<Kind> * detail::quantum_bytes<Kind>;
 
-            for (std::size_t i{}; i < 16; ++i)
-                *(first++) = alphabet[(data >> (64 - (i + 1) * 4)) & 15];
-        }
-    }
-    else // 32-bit machine
-    {
-        for (; end - begin > 3; begin += 4)
-        {
-            auto data = chars_to_int_big_endian<4>(begin);
+    if (!chunk)
+        threads = 1;
 
-            for (std::size_t i{}; i < 8; ++i)
-                *(first++) = alphabet[(data >> (32 - (i + 1) * 4)) & 15];
-        }
-    }
+    detail::parallel_for(threads, [&](std::size_t i) {
+        auto chunk_begin = begin + i * chunk;
+        auto chunk_end = i + 1 == threads ? end : chunk_begin + chunk;
+        auto chunk_first = first + static_cast<diff>(detail::encoded_size<Kind, true>(i * chunk));
 
-    for (; begin != end; ++begin)
-    {
-        auto data = to_uc(*begin);
+        encode_impl_any<Kind, Padding>(chunk_begin, chunk_end, chunk_first);
+    });
 
-        *first = alphabet[data >> 4];
-        ++first;
-        *first = alphabet[data & 15];
-        ++first;
-    }
+    first += static_cast<diff>(detail::encoded_size<Kind, Padding>(size));
 }
 
 struct rfc4648_encode_fn
@@ -531,8 +1263,21 @@ struct rfc4648_encode_fn
         auto begin_ptr = detail::to_address_const(begin);
         auto end_ptr = detail::to_address_const(end);
 
+        // NB: a string or vector is grown once and written through a pointer
+        if constexpr (detail::contiguous_back_inserter<Out>)
+        {
+            auto n = detail::encoded_size<Kind, Padding>(static_cast<std::size_t>(end_ptr - begin_ptr));
+
+            detail::append_and_fill(detail::get_container(first), n, [begin_ptr, end_ptr](auto ptr) {
+                return static_cast<std::size_t>(rfc4648_encode_fn{}.operator()<Kind, Padding>(begin_ptr, end_ptr, ptr) -
+                                                ptr);
+            });
+
+            return first;
+        }
+
         if constexpr (detail::get_family<Kind>() == rfc4648_kind::base64)
-            encode_impl::encode_impl_b64<Padding>(encode_impl::get_alphabet<Kind>(), begin_ptr, end_ptr, first);
+            encode_impl::encode_impl_b64<Kind, Padding>(encode_impl::get_alphabet<Kind>(), begin_ptr, end_ptr, first);
         if constexpr (detail::get_family<Kind>() == rfc4648_kind::base32)
             encode_impl::encode_impl_b32<Padding>(encode_impl::get_alphabet<Kind>(), begin_ptr, end_ptr, first);
         if constexpr (detail::get_family<Kind>() == rfc4648_kind::base16)
@@ -554,6 +1299,81 @@ struct rfc4648_encode_fn
         return operator()<Kind, Padding>(std::ranges::begin(r), std::ranges::end(r), first);
     }
 
+    // NB: the size is known at compile time, the chars are returned by value
+    template <rfc4648_kind Kind = rfc4648_kind::base64, bool Padding = true, typename T, std::size_t N>
+        requires(N != std::dynamic_extent)
+#if defined(__cpp_static_call_operator) && __cpp_static_call_operator >= 202207L
+    static
+#endif
+        inline constexpr std::array<char, detail::encoded_size<Kind, Padding>(N)>
+        operator()(std::span<T, N> bytes)
+#if !defined(__cpp_static_call_operator) || __cpp_static_call_operator < 202207L
+            const
+#endif
+    {
+        using in_char = std::remove_cv_t<T>;
+
+        static_assert(std::is_same_v<in_char, char> || std::is_same_v<in_char, unsigned char> ||
+                      std::is_same_v<in_char, std::byte>);
+
+        return encode_impl::encode_impl_fixed<Kind, Padding, N>(bytes.data());
+    }
+
+    template <rfc4648_kind Kind = rfc4648_kind::base64, bool Padding = true, typename T, std::size_t N>
+#if defined(__cpp_static_call_operator) && __cpp_static_call_operator >= 202207L
+    static
+#endif
+        inline constexpr std::array<char, detail::encoded_size<Kind, Padding>(N)>
+        operator()(std::array<T, N> const &bytes)
+#if !defined(__cpp_static_call_operator) || __cpp_static_call_operator < 202207L
+            const
+#endif
+    {
+        return rfc4648_encode_fn{}.operator()<Kind, Padding>(std::span<T const, N>{bytes});
+    }
+
+    // NB: runs on one thread unless Out is random access
+    template <rfc4648_kind Kind = rfc4648_kind::base64, bool Padding = true, typename In, typename Out>
+#if defined(__cpp_static_call_operator) && __cpp_static_call_operator >= 202207L
+    static
+#endif
+        inline Out
+        operator()(rfc4648_parallel parallel, In begin, In end, Out first)
+#if !defined(__cpp_static_call_operator) || __cpp_static_call_operator < 202207L
+            const
+#endif
+    {
+        using in_char = std::iterator_traits<In>::value_type;
+
+        static_assert(std::contiguous_iterator<In>);
+        static_assert(std::is_same_v<in_char, char> || std::is_same_v<in_char, unsigned char> ||
+                      std::is_same_v<in_char, std::byte>);
+
+        auto begin_ptr = detail::to_address_const(begin);
+        auto end_ptr = detail::to_address_const(end);
+        auto threads = detail::get_thread_count(parallel, static_cast<std::size_t>(end_ptr - begin_ptr));
+
+        if constexpr (std::random_access_iterator<Out>)
+            encode_impl::encode_impl_parallel<Kind, Padding>(threads, begin_ptr, end_ptr, first);
+        else
+            encode_impl::encode_impl_any<Kind, Padding>(begin_ptr, end_ptr, first);
+
+        return first;
+    }
+
+    template <rfc4648_kind Kind = rfc4648_kind::base64, bool Padding = true, typename R, typename Out>
+#if defined(__cpp_static_call_operator) && __cpp_static_call_operator >= 202207L
+    static
+#endif
+        inline Out
+        operator()(rfc4648_parallel parallel, R &&r, Out first)
+#if !defined(__cpp_static_call_operator) || __cpp_static_call_operator < 202207L
+            const
+#endif
+    {
+        return operator()<Kind, Padding>(parallel, std::ranges::begin(r), std::ranges::end(r), first);
+    }
+
     // NB: don't need padding
     template <rfc4648_kind Kind = rfc4648_kind::base64, typename In, typename Out>
 #if defined(__cpp_static_call_operator) && __cpp_static_call_operator >= 202207L
@@ -574,6 +1394,19 @@ struct rfc4648_encode_fn
         auto begin_ptr = detail::to_address_const(begin);
         auto end_ptr = detail::to_address_const(end);
 
+        if constexpr (detail::contiguous_back_inserter<Out>)
+        {
+            auto n = detail::encoded_size<Kind, true>(static_cast<std::size_t>(end_ptr - begin_ptr) +
+                                                      detail::quantum_bytes<Kind>);
+
+            detail::append_and_fill(detail::get_container(first), n, [&ctx, begin_ptr, end_ptr](auto ptr) {
+                return static_cast<std::size_t>(rfc4648_encode_fn{}.operator()<Kind>(ctx, begin_ptr, end_ptr, ptr) -
+                                                ptr);
+            });
+
+            return first;
+        }
+
         if constexpr (detail::get_family<Kind>() == rfc4648_kind::base64)
             encode_impl::encode_impl_b64_ctx(encode_impl::get_alphabet<Kind>(), ctx.buf_, ctx.sig_, begin_ptr, end_ptr,
                                              first);
@@ -611,7 +1444,206 @@ struct rfc4648_encode_fn
         return first;
     }
 };
+
+struct rfc4648_encode_wrap_fn
+{
+    // NB: a line_length of 0 disables wrapping, no separator is written after the last line
+    template <rfc4648_kind Kind = rfc4648_kind::base64, bool Padding = true, typename In, typename Out>
+#if defined(__cpp_static_call_operator) && __cpp_static_call_operator >= 202207L
+    static
+#endif
+        inline constexpr Out
+        operator()(In begin, In end, Out first, std::size_t line_length, std::string_view separator)
+#if !defined(__cpp_static_call_operator) || __cpp_static_call_operator < 202207L
+            const
+#endif
+    {
+        using in_char = std::iterator_traits<In>::value_type;
+
+        static_assert(std::contiguous_iterator<In>);
+        static_assert(std::is_same_v<in_char, char> || std::is_same_v<in_char, unsigned char> ||
+                      std::is_same_v<in_char, std::byte>);
+
+        auto begin_ptr = detail::to_address_const(begin);
+        auto end_ptr = detail::to_address_const(end);
+        std::size_t col{};
+
+        if (!line_length)
+            line_length = static_cast<std::size_t>(-1);
+
+        begin_ptr = encode_impl::encode_impl_wrap<Kind>(begin_ptr, end_ptr, first, line_length, separator, col);
+        encode_impl::encode_impl_wrap_tail<Kind, Padding>(begin_ptr, end_ptr, first, line_length, separator, col);
+
+        return first;
+    }
+
+    template <rfc4648_kind Kind = rfc4648_kind::base64, bool Padding = true, typename R, typename Out>
+#if defined(__cpp_static_call_operator) && __cpp_static_call_operator >= 202207L
+    static
+#endif
+        inline constexpr Out
+        operator()(R &&r, Out first, std::size_t line_length, std::string_view separator)
+#if !defined(__cpp_static_call_operator) || __cpp_static_call_operator < 202207L
+            const
+#endif
+    {
+        return rfc4648_encode_wrap_fn{}.operator()<Kind, Padding>(std::ranges::begin(r), std::ranges::end(r), first,
+                                                                  line_length, separator);
+    }
+
+    // NB: don't need padding, the column is kept in ctx
+    template <rfc4648_kind Kind = rfc4648_kind::base64, typename In, typename Out>
+#if defined(__cpp_static_call_operator) && __cpp_static_call_operator >= 202207L
+    static
+#endif
+        inline constexpr Out
+        operator()(rfc4648_context &ctx, In begin, In end, Out first, std::size_t line_length,
+                   std::string_view separator)
+#if !defined(__cpp_static_call_operator) || __cpp_static_call_operator < 202207L
+            const
+#endif
+    {
+        using in_char = std::iterator_traits<In>::value_type;
+
+        static_assert(std::contiguous_iterator<In>);
+        static_assert(std::is_same_v<in_char, char> || std::is_same_v<in_char, unsigned char> ||
+                      std::is_same_v<in_char, std::byte>);
+
+        auto begin_ptr = detail::to_address_const(begin);
+        auto end_ptr = detail::to_address_const(end);
+
+        if (!line_length)
+            line_length = static_cast<std::size_t>(-1);
+
+        encode_impl::encode_impl_wrap_ctx<Kind>(ctx.buf_, ctx.sig_, ctx.col_, begin_ptr, end_ptr, first, line_length,
+                                                separator);
+
+        return first;
+    }
+
+    template <rfc4648_kind Kind = rfc4648_kind::base64, typename R, typename Out>
+#if defined(__cpp_static_call_operator) && __cpp_static_call_operator >= 202207L
+    static
+#endif
+        inline constexpr Out
+        operator()(rfc4648_context &ctx, R &&r, Out first, std::size_t line_length, std::string_view separator)
+#if !defined(__cpp_static_call_operator) || __cpp_static_call_operator < 202207L
+            const
+#endif
+    {
+        return rfc4648_encode_wrap_fn{}.operator()<Kind>(ctx, std::ranges::begin(r), std::ranges::end(r), first,
+                                                         line_length, separator);
+    }
+
+    template <rfc4648_kind Kind = rfc4648_kind::base64, bool Padding = true, typename Out>
+#if defined(__cpp_static_call_operator) && __cpp_static_call_operator >= 202207L
+    static
+#endif
+        inline constexpr Out
+        operator()(rfc4648_context &ctx, Out first, std::size_t line_length, std::string_view separator)
+#if !defined(__cpp_static_call_operator) || __cpp_static_call_operator < 202207L
+            const
+#endif
+    {
+        if (!line_length)
+            line_length = static_cast<std::size_t>(-1);
+
+        encode_impl::encode_impl_wrap_tail<Kind, Padding>(std::begin(ctx.buf_), std::begin(ctx.buf_) + ctx.sig_, first,
+                                                          line_length, separator, ctx.col_);
+        ctx.sig_ = 0;
+        ctx.col_ = 0;
+
+        return first;
+    }
+};
+
+struct rfc4648_encode_to_fn
+{
+    // NB: replaces the content of c
+    template <rfc4648_kind Kind = rfc4648_kind::base64, bool Padding = true, typename R, typename C>
+#if defined(__cpp_static_call_operator) && __cpp_static_call_operator >= 202207L
+    static
+#endif
+        inline constexpr void
+        operator()(R &&r, C &c)
+#if !defined(__cpp_static_call_operator) || __cpp_static_call_operator < 202207L
+            const
+#endif
+    {
+        auto n = detail::encoded_size<Kind, Padding>(std::ranges::size(r));
+
+        detail::resize_and_fill(c, n, [&r](auto ptr) {
+            return static_cast<std::size_t>(rfc4648_encode_fn{}.operator()<Kind, Padding>(r, ptr) - ptr);
+        });
+    }
+};
+
+struct rfc4648_encode_batch_fn
+{
+    // NB: the messages are written back to back from first, the number of
+    // chars of each is written to sizes
+    template <rfc4648_kind Kind = rfc4648_kind::base64, bool Padding = true, typename R, typename Out,
+              typename Sizes>
+#if defined(__cpp_static_call_operator) && __cpp_static_call_operator >= 202207L
+    static
+#endif
+        inline constexpr Out
+        operator()(R &&messages, Out first, Sizes sizes)
+#if !defined(__cpp_static_call_operator) || __cpp_static_call_operator < 202207L
+            const
+#endif
+    {
+        using message = std::ranges::range_reference_t<R>;
+        using in_char = std::ranges::range_value_t<message>;
+
+        static_assert(std::ranges::contiguous_range<message> && std::ranges::sized_range<message>);
+        static_assert(std::is_same_v<in_char, char> || std::is_same_v<in_char, unsigned char> ||
+                      std::is_same_v<in_char, std::byte>);
+
+#if defined(BIZWEN_RFC4648_HAS_SIMD)
+        if constexpr (detail::narrow_contiguous_iterator<Out>)
+        {
+#if defined(__cpp_if_consteval) && (__cpp_if_consteval >= 202106L)
+            if !consteval
+#else
+            if (!::std::is_constant_evaluated())
+#endif
+            {
+                if (auto kernel = encode_impl::get_encode_kernel<detail::get_family<Kind>(), Padding>())
+                {
+                    auto out = reinterpret_cast<unsigned char *>(std::to_address(first));
+
+                    for (auto &&m : messages)
+                    {
+                        auto begin = reinterpret_cast<unsigned char const *>(std::ranges::data(m));
+                        auto last = encode_impl::encode_impl_batch_item<Kind, Padding>(kernel, begin,
+                                                                                       std::ranges::size(m), out);
+
+                        *sizes = static_cast<std::size_t>(last - out);
+                        ++sizes;
+                        out = last;
+                    }
+
+                    return first + (out - reinterpret_cast<unsigned char *>(std::to_address(first)));
+                }
+            }
+        }
+#endif
+
+        for (auto &&m : messages)
+        {
+            first = rfc4648_encode_fn{}.operator()<Kind, Padding>(m, first);
+            *sizes = detail::encoded_size<Kind, Padding>(std::ranges::size(m));
+            ++sizes;
+        }
+
+        return first;
+    }
+};
 } // namespace encode_impl
 
 inline constexpr encode_impl::rfc4648_encode_fn rfc4648_encode;
+inline constexpr encode_impl::rfc4648_encode_to_fn rfc4648_encode_to;
+inline constexpr encode_impl::rfc4648_encode_wrap_fn rfc4648_encode_wrap;
+inline constexpr encode_impl::rfc4648_encode_batch_fn rfc4648_encode_batch;
 } // namespace bizwen
@@ -1,6 +1,10 @@
 #include "decode.hpp"
 #include "encode.hpp"
+#include "streambuf.hpp"
+#include <array>
 #include <cassert>
+#include <ostream>
+#include <sstream>
 #include <string>
 #include <string_view>
 
@@ -8,12 +12,10 @@ int main()
 {
     std::string_view src{"ABCDEFGHIJKLMN"};
     std::string encoded;
-    encoded.resize((src.size() + 3) / 3 * 4);
-    bizwen::rfc4648_encode(src.begin(), src.end(), encoded.begin());
+    bizwen::rfc4648_encode_to(src, encoded);
     std::string decoded;
-    decoded.resize(src.size());
-    bizwen::rfc4648_decode(encoded.begin(), encoded.end(), decoded.begin());
-    assert(encoded == decoded);
+    bizwen::rfc4648_decode_to(encoded, decoded);
+    assert(src == decoded);
 
     std::string dest1;
     dest1.resize((src.size() * 3 + 3) / 3 * 4);
@@ -30,4 +32,18 @@ int main()
     std::wstring dest3;
     dest3.resize((src.size() + 3) / 3 * 4);
     bizwen::rfc4648_encode((std::byte *)src.data(), (std::byte *)src.data() + src.size(), dest3.begin());
+
+    constexpr std::array<unsigned char, 16> uuid{0x01, 0x8f, 0x3a, 0x5c, 0x7d, 0x22, 0x4b, 0x10,
+                                                 0x9e, 0x61, 0x0c, 0xd4, 0x52, 0xa7, 0x33, 0xe8};
+    constexpr auto id = bizwen::rfc4648_encode.operator()<bizwen::rfc4648_kind::base32_crockford, false>(uuid);
+    static_assert(id.size() == 26);
+    static_assert(bizwen::rfc4648_decode.operator()<bizwen::rfc4648_kind::base32_crockford>(id) == uuid);
+
+    std::stringbuf sink;
+    {
+        bizwen::rfc4648_encode_streambuf<> buf(&sink);
+        std::ostream os(&buf);
+        os << src << src;
+    }
+    assert(sink.str() == "QUJDREVGR0hJSktMTU5BQkNERUZHSElKS0xNTg==");
 }
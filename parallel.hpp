@@ -0,0 +1,76 @@
+#pragma once
+
+#include <algorithm> // std::min
+#include <cstddef> // std::size_t
+#include <exception> // std::exception_ptr
+#include <thread> // std::thread
+#include <vector>
+
+namespace bizwen
+{
+// tag of the multi-threaded overloads, 0 threads means
+// std::thread::hardware_concurrency()
+struct rfc4648_parallel
+{
+    std::size_t threads{};
+};
+
+namespace detail
+{
+// at least this many input units go to each thread
+inline constexpr std::size_t parallel_min_chunk = std::size_t(1) << 18;
+
+inline std::size_t get_thread_count(rfc4648_parallel parallel, std::size_t size) noexcept
+{
+    std::size_t threads = parallel.threads ? parallel.threads : std::thread::hardware_concurrency();
+
+    return std::max(std::size_t(1), std::min(threads, size / parallel_min_chunk));
+}
+
+// call f(0) ... f(n - 1) on n threads, the calling thread takes the last one,
+// the first exception is rethrown after all threads are joined
+template <typename F>
+inline void parallel_for(std::size_t n, F f)
+{
+    std::vector<std::exception_ptr> errors(n);
+    std::vector<std::thread> threads;
+
+    auto run = [&f, &errors](std::size_t i) noexcept {
+        try
+        {
+            f(i);
+        }
+        catch (...)
+        {
+            errors[i] = std::current_exception();
+        }
+    };
+
+    threads.reserve(n - 1);
+
+    try
+    {
+        for (std::size_t i{}; i != n - 1; ++i)
+            threads.emplace_back(run, i);
+    }
+    catch (...)
+    {
+        for (auto &thread : threads)
+            thread.join();
+
+        throw;
+    }
+
+    run(n - 1);
+
+    for (auto &thread : threads)
+        thread.join();
+
+    for (auto &error : errors)
+    {
+        if (error)
+            std::rethrow_exception(error);
+    }
+}
+} // namespace detail
+} // namespace bizwen
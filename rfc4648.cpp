@@ -0,0 +1,323 @@
+#include "decode.hpp"
+#include "encode.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std::string_view_literals;
+
+// encode or decode a file or stdin to stdout, like basenc(1)
+// usage: rfc4648 [--base64 | --base64url | --base32 | ... ] [-d] [-i] [-w COLS] [--no-padding] [FILE]
+
+namespace
+{
+constexpr std::size_t block_size = std::size_t(1) << 20;
+
+struct options
+{
+    bizwen::rfc4648_kind kind{bizwen::rfc4648_kind::base64};
+    bool decode{};
+    bool ignore_garbage{};
+    bool padding{true};
+    std::size_t wrap{76};
+    char const *file{};
+};
+
+constexpr std::pair<std::string_view, bizwen::rfc4648_kind> kinds[] = {
+    {"--base64"sv, bizwen::rfc4648_kind::base64},
+    {"--base64url"sv, bizwen::rfc4648_kind::base64_url},
+    {"--base32"sv, bizwen::rfc4648_kind::base32},
+    {"--base32lower"sv, bizwen::rfc4648_kind::base32_lower},
+    {"--base32hex"sv, bizwen::rfc4648_kind::base32_hex},
+    {"--base32hexlower"sv, bizwen::rfc4648_kind::base32_hex_lower},
+    {"--base32crockford"sv, bizwen::rfc4648_kind::base32_crockford},
+    {"--base32crockfordlower"sv, bizwen::rfc4648_kind::base32_crockford_lower},
+    {"--base16"sv, bizwen::rfc4648_kind::base16},
+    {"--base16lower"sv, bizwen::rfc4648_kind::base16_lower},
+};
+
+[[noreturn]] void usage(int status)
+{
+    std::fputs("usage: rfc4648 [KIND] [-d] [-i] [-w COLS] [--no-padding] [FILE]\n"
+               "  KIND is one of --base64 (default), --base64url, --base32, --base32lower, --base32hex,\n"
+               "  --base32hexlower, --base32crockford, --base32crockfordlower, --base16, --base16lower\n"
+               "  -d, --decode          decode FILE, or standard input if FILE is missing or -\n"
+               "  -i, --ignore-garbage  when decoding, skip characters outside the alphabet\n"
+               "  -w, --wrap=COLS       wrap encoded lines after COLS characters (default 76), 0 disables\n"
+               "  --no-padding          do not write padding when encoding\n",
+               status ? stderr : stdout);
+    std::exit(status);
+}
+
+[[noreturn]] void fail(char const *what)
+{
+    std::fprintf(stderr, "rfc4648: %s: %s\n", what, std::strerror(errno));
+    std::exit(1);
+}
+
+std::size_t parse_wrap(char const *s)
+{
+    char *end;
+    errno = 0;
+    auto n = std::strtoull(s, &end, 10);
+
+    if (errno || end == s || *end || *s == '-')
+    {
+        std::fprintf(stderr, "rfc4648: invalid wrap size: %s\n", s);
+        std::exit(1);
+    }
+
+    return static_cast<std::size_t>(n);
+}
+
+options parse(int argc, char **argv)
+{
+    options opts;
+
+    for (int i = 1; i != argc; ++i)
+    {
+        std::string_view arg{argv[i]};
+        bool found{};
+
+        for (auto [name, kind] : kinds)
+        {
+            if (arg == name)
+            {
+                opts.kind = kind;
+                found = true;
+            }
+        }
+
+        if (found)
+            continue;
+
+        if (arg == "-d"sv || arg == "--decode"sv)
+            opts.decode = true;
+        else if (arg == "-i"sv || arg == "--ignore-garbage"sv)
+            opts.ignore_garbage = true;
+        else if (arg == "--no-padding"sv)
+            opts.padding = false;
+        else if ((arg == "-w"sv || arg == "--wrap"sv) && i + 1 != argc)
+            opts.wrap = parse_wrap(argv[++i]);
+        else if (arg.starts_with("--wrap="sv))
+            opts.wrap = parse_wrap(argv[i] + 7);
+        else if (arg.starts_with("-w"sv))
+            opts.wrap = parse_wrap(argv[i] + 2);
+        else if (arg == "-h"sv || arg == "--help"sv)
+            usage(0);
+        else if ((arg == "-"sv || !arg.starts_with('-')) && !opts.file)
+            opts.file = argv[i];
+        else
+            usage(1);
+    }
+
+    return opts;
+}
+
+void write_all(char const *data, std::size_t n)
+{
+    while (n)
+    {
+        auto r = ::write(STDOUT_FILENO, data, n);
+
+        if (r < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            fail("write error");
+        }
+
+        data += r;
+        n -= static_cast<std::size_t>(r);
+    }
+}
+
+// calls f(begin, end) on blocks of the input, a regular file is mapped and
+// passed in one block, other inputs are read in blocks of block_size
+template <typename F>
+void for_each_block(int fd, F f)
+{
+    struct stat st;
+
+    if (::fstat(fd, &st))
+        fail("stat error");
+
+    if (S_ISREG(st.st_mode) && st.st_size > 0)
+    {
+        auto size = static_cast<std::size_t>(st.st_size);
+        auto map = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (map != MAP_FAILED)
+        {
+            ::madvise(map, size, MADV_SEQUENTIAL);
+
+            auto begin = static_cast<char const *>(map);
+
+            // blocks only bound the output buffer, the kernel reads ahead
+            for (std::size_t i{}; i < size; i += block_size)
+                f(begin + i, begin + std::min(size, i + block_size));
+
+            ::munmap(map, size);
+
+            return;
+        }
+    }
+
+    std::vector<char> buf(block_size);
+
+    while (true)
+    {
+        std::size_t n{};
+
+        // fill the whole block, pipes return at most 64 KiB per read
+        while (n != buf.size())
+        {
+            auto r = ::read(fd, buf.data() + n, buf.size() - n);
+
+            if (r < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+
+                fail("read error");
+            }
+
+            if (r == 0)
+                break;
+
+            n += static_cast<std::size_t>(r);
+        }
+
+        if (n)
+            f(buf.data(), buf.data() + n);
+
+        if (n != buf.size())
+            return;
+    }
+}
+
+template <bizwen::rfc4648_kind Kind, bool Padding>
+void encode(int fd, options const &opts)
+{
+    constexpr auto separator = "\n"sv;
+    auto chars = bizwen::rfc4648_encoded_size<Kind>(block_size + 8);
+    auto lines = opts.wrap ? chars / opts.wrap + 1 : 0;
+    std::vector<char> out(chars + lines * separator.size() + 1);
+    bizwen::rfc4648_context ctx;
+    bool empty{true};
+
+    for_each_block(fd, [&](char const *begin, char const *end) {
+        auto last = bizwen::rfc4648_encode_wrap.operator()<Kind>(ctx, begin, end, out.data(), opts.wrap, separator);
+
+        write_all(out.data(), static_cast<std::size_t>(last - out.data()));
+        empty = false;
+    });
+
+    auto last = bizwen::rfc4648_encode_wrap.operator()<Kind, Padding>(ctx, out.data(), opts.wrap, separator);
+
+    // like base64(1), wrapped output ends with a newline
+    if (opts.wrap && !empty)
+        *last++ = '\n';
+
+    write_all(out.data(), static_cast<std::size_t>(last - out.data()));
+}
+
+template <bizwen::rfc4648_kind Kind>
+void decode(int fd, options const &opts)
+{
+    std::vector<char> out(bizwen::rfc4648_max_decoded_size<Kind>(block_size) + 8);
+    bizwen::rfc4648_context ctx;
+    bool padded{};
+
+    for_each_block(fd, [&](char const *begin, char const *end) {
+        auto first = out.data();
+
+        while (begin != end)
+        {
+            if (!padded || opts.ignore_garbage)
+            {
+                auto [last, o] = bizwen::rfc4648_decode.operator()<Kind, true>(ctx, begin, end, first);
+
+                begin = last;
+                first = o;
+
+                if (begin == end)
+                    break;
+            }
+
+            // after padding only more padding and whitespace may follow, -i
+            // skips any other char and starts a new quantum after padding
+            if (*begin == '=' && bizwen::detail::get_family<Kind>() != bizwen::rfc4648_kind::base16)
+            {
+                first = bizwen::rfc4648_decode.operator()<Kind>(ctx, first);
+                padded = true;
+            }
+            else if (!opts.ignore_garbage && !(padded && bizwen::decode_impl::is_space(*begin)))
+            {
+                write_all(out.data(), static_cast<std::size_t>(first - out.data()));
+                std::fputs("rfc4648: invalid input\n", stderr);
+                std::exit(1);
+            }
+
+            ++begin;
+        }
+
+        write_all(out.data(), static_cast<std::size_t>(first - out.data()));
+    });
+
+    auto last = bizwen::rfc4648_decode.operator()<Kind>(ctx, out.data());
+
+    write_all(out.data(), static_cast<std::size_t>(last - out.data()));
+}
+
+template <bizwen::rfc4648_kind Kind>
+void run(int fd, options const &opts)
+{
+    if (opts.decode)
+        decode<Kind>(fd, opts);
+    else if (opts.padding)
+        encode<Kind, true>(fd, opts);
+    else
+        encode<Kind, false>(fd, opts);
+}
+
+template <std::size_t I = 0>
+void dispatch(int fd, options const &opts)
+{
+    if constexpr (I != std::size(kinds))
+    {
+        if (opts.kind == kinds[I].second)
+            run<kinds[I].second>(fd, opts);
+        else
+            dispatch<I + 1>(fd, opts);
+    }
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    auto opts = parse(argc, argv);
+    int fd = STDIN_FILENO;
+
+    if (opts.file && opts.file != "-"sv)
+    {
+        fd = ::open(opts.file, O_RDONLY);
+
+        if (fd < 0)
+            fail(opts.file);
+    }
+
+    dispatch(fd, opts);
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstddef> // std::size_t
+#include <cstdlib> // std::getenv
+#include <cstring> // std::strcmp
+
+#if !defined(BIZWEN_RFC4648_NO_SIMD) && (defined(__x86_64__) || defined(_M_X64))
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+// Vector kernels are always compiled, each for its own target ISA, and are
+// selected at runtime by detail::get_simd_level(). Define BIZWEN_RFC4648_NO_SIMD
+// to only use the scalar code.
+#define BIZWEN_RFC4648_HAS_SIMD 1
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#define BIZWEN_RFC4648_TARGET_SSSE3
+#define BIZWEN_RFC4648_TARGET_AVX2
+#define BIZWEN_RFC4648_TARGET_AVX512VBMI
+#else
+#define BIZWEN_RFC4648_TARGET_SSSE3 __attribute__((target("ssse3")))
+#define BIZWEN_RFC4648_TARGET_AVX2 __attribute__((target("avx2")))
+#define BIZWEN_RFC4648_TARGET_AVX512VBMI __attribute__((target("avx512f,avx512bw,avx512vbmi")))
+#endif
+#endif
+
+namespace bizwen
+{
+namespace detail
+{
+enum class simd_level : unsigned char
+{
+    scalar,
+    ssse3,
+    avx2,
+    avx512vbmi
+};
+
+inline simd_level detect_simd_level() noexcept
+{
+#if defined(BIZWEN_RFC4648_HAS_SIMD)
+    unsigned int regs[4]{};
+
+    auto cpuid = [&regs](unsigned int leaf) noexcept {
+#if defined(_MSC_VER) && !defined(__clang__)
+        __cpuidex(reinterpret_cast<int *>(regs), static_cast<int>(leaf), 0);
+#else
+        __cpuid_count(leaf, 0, regs[0], regs[1], regs[2], regs[3]);
+#endif
+    };
+
+    cpuid(0);
+    auto max_leaf = regs[0];
+
+    cpuid(1);
+    bool ssse3 = regs[2] & (1u << 9);
+    bool osxsave = regs[2] & (1u << 27);
+
+    if (!ssse3)
+        return simd_level::scalar;
+    if (!osxsave || max_leaf < 7)
+        return simd_level::ssse3;
+
+    // the OS must save the YMM (and ZMM) state
+#if defined(_MSC_VER) && !defined(__clang__)
+    auto xcr0 = static_cast<unsigned long long>(_xgetbv(0));
+#else
+    unsigned int xcr0_lo, xcr0_hi;
+    __asm__("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+    auto xcr0 = static_cast<unsigned long long>(xcr0_hi) << 32 | xcr0_lo;
+#endif
+
+    cpuid(7);
+    bool avx2 = regs[1] & (1u << 5);
+    // AVX512F, AVX512BW, AVX512VBMI
+    bool avx512vbmi = (regs[1] & (1u << 16)) && (regs[1] & (1u << 30)) && (regs[2] & (1u << 1));
+
+    if (!avx2 || (xcr0 & 0x06) != 0x06)
+        return simd_level::ssse3;
+    if (!avx512vbmi || (xcr0 & 0xE6) != 0xE6)
+        return simd_level::avx2;
+
+    return simd_level::avx512vbmi;
+#else
+    return simd_level::scalar;
+#endif
+}
+
+// detected once, BIZWEN_RFC4648_SIMD=scalar|ssse3|avx2 lowers the level
+inline simd_level get_simd_level() noexcept
+{
+    static simd_level const level = []() noexcept {
+        auto detected = detect_simd_level();
+        auto requested = std::getenv("BIZWEN_RFC4648_SIMD");
+        auto forced = detected;
+
+        if (!requested)
+            return detected;
+
+        if (!std::strcmp(requested, "scalar"))
+            forced = simd_level::scalar;
+        else if (!std::strcmp(requested, "ssse3"))
+            forced = simd_level::ssse3;
+        else if (!std::strcmp(requested, "avx2"))
+            forced = simd_level::avx2;
+
+        return forced < detected ? forced : detected;
+    }();
+
+    return level;
+}
+
+inline constexpr unsigned long long mask_first_n(std::size_t n) noexcept
+{
+    return n >= 64 ? ~0ull : (1ull << n) - 1;
+}
+} // namespace detail
+} // namespace bizwen
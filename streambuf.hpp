@@ -0,0 +1,206 @@
+#pragma once
+
+#include <algorithm> // std::min
+#include <cstddef> // std::size_t
+#include <cstring> // std::memcpy
+#include <streambuf>
+#include <vector>
+
+#include "./common.hpp"
+#include "./decode.hpp"
+#include "./encode.hpp"
+
+namespace bizwen
+{
+namespace detail
+{
+inline constexpr std::size_t streambuf_buffer_size = std::size_t(1) << 16;
+} // namespace detail
+
+// encodes the bytes written to it into the downstream streambuf, pubsync() and
+// the destructor write the final quantum with padding, so each sync ends one
+// encoded text
+template <rfc4648_kind Kind = rfc4648_kind::base64, bool Padding = true>
+class rfc4648_encode_streambuf : public std::streambuf
+{
+    std::streambuf *down_;
+    rfc4648_context ctx_;
+    std::vector<char> in_;
+    std::vector<char> out_;
+
+    bool write(char const *last)
+    {
+        auto n = static_cast<std::streamsize>(last - out_.data());
+
+        return down_->sputn(out_.data(), n) == n;
+    }
+
+    bool encode(char const *begin, char const *end)
+    {
+        return write(rfc4648_encode.operator()<Kind>(ctx_, begin, end, out_.data()));
+    }
+
+    bool encode_buffer()
+    {
+        auto begin = pbase();
+        auto end = pptr();
+
+        setp(in_.data(), in_.data() + in_.size());
+
+        return begin == end || encode(begin, end);
+    }
+
+  public:
+    explicit rfc4648_encode_streambuf(std::streambuf *down, std::size_t buffer_size = detail::streambuf_buffer_size)
+        : down_(down), in_(std::max(buffer_size, detail::quantum_bytes<Kind>)),
+          out_(detail::encoded_size<Kind, true>(in_.size() + detail::quantum_bytes<Kind>))
+    {
+        setp(in_.data(), in_.data() + in_.size());
+    }
+
+    rfc4648_encode_streambuf(rfc4648_encode_streambuf const &) = delete;
+    rfc4648_encode_streambuf &operator=(rfc4648_encode_streambuf const &) = delete;
+
+    ~rfc4648_encode_streambuf() override
+    {
+        try
+        {
+            sync();
+        }
+        catch (...)
+        {
+        }
+    }
+
+  protected:
+    int_type overflow(int_type c) override
+    {
+        if (!encode_buffer())
+            return traits_type::eof();
+
+        if (!traits_type::eq_int_type(c, traits_type::eof()))
+        {
+            *pptr() = traits_type::to_char_type(c);
+            pbump(1);
+        }
+
+        return traits_type::not_eof(c);
+    }
+
+    // NB: writes of at least a whole buffer are encoded without copying
+    std::streamsize xsputn(char const *s, std::streamsize n) override
+    {
+        auto size = static_cast<std::streamsize>(in_.size());
+        std::streamsize done{};
+
+        if (n >= epptr() - pptr())
+        {
+            if (!encode_buffer())
+                return 0;
+
+            for (; n - done >= size; done += size)
+            {
+                if (!encode(s + done, s + done + size))
+                    return done;
+            }
+        }
+
+        std::memcpy(pptr(), s + done, static_cast<std::size_t>(n - done));
+        pbump(static_cast<int>(n - done));
+
+        return n;
+    }
+
+    int sync() override
+    {
+        if (!encode_buffer())
+            return -1;
+
+        if (!write(rfc4648_encode.operator()<Kind, Padding>(ctx_, out_.data())))
+            return -1;
+
+        return down_->pubsync();
+    }
+};
+
+// decodes the chars read from the downstream streambuf, ASCII whitespace is
+// skipped if IgnoreSpace is true
+// NB: the stream ends at the first invalid char, such as padding, the chars
+// read after it from the downstream streambuf are discarded
+template <rfc4648_kind Kind = rfc4648_kind::base64, bool IgnoreSpace = false>
+class rfc4648_decode_streambuf : public std::streambuf
+{
+    std::streambuf *down_;
+    rfc4648_context ctx_;
+    std::vector<char> in_;
+    std::vector<char> out_;
+    bool done_{};
+
+    // decode the next buffer of the downstream streambuf into first, returns
+    // the end of the output
+    char *decode(char *first)
+    {
+        auto n = down_->sgetn(in_.data(), static_cast<std::streamsize>(in_.size()));
+
+        if (n > 0)
+        {
+            auto end = in_.data() + n;
+            auto [last, out] = rfc4648_decode.operator()<Kind, IgnoreSpace>(ctx_, in_.data(), end, first);
+
+            first = out;
+            done_ = last != end;
+        }
+        else
+        {
+            done_ = true;
+        }
+
+        if (done_)
+            first = rfc4648_decode.operator()<Kind>(ctx_, first);
+
+        return first;
+    }
+
+  public:
+    explicit rfc4648_decode_streambuf(std::streambuf *down, std::size_t buffer_size = detail::streambuf_buffer_size)
+        : down_(down), in_(std::max(buffer_size, detail::quantum_chars<Kind>)),
+          out_(detail::decoded_size<Kind>(in_.size()) + detail::quantum_bytes<Kind>)
+    {
+        setg(out_.data(), out_.data(), out_.data());
+    }
+
+    rfc4648_decode_streambuf(rfc4648_decode_streambuf const &) = delete;
+    rfc4648_decode_streambuf &operator=(rfc4648_decode_streambuf const &) = delete;
+
+  protected:
+    int_type underflow() override
+    {
+        while (gptr() == egptr())
+        {
+            if (done_)
+                return traits_type::eof();
+
+            setg(out_.data(), out_.data(), decode(out_.data()));
+        }
+
+        return traits_type::to_int_type(*gptr());
+    }
+
+    // NB: reads of at least a whole buffer are decoded without copying
+    std::streamsize xsgetn(char *s, std::streamsize n) override
+    {
+        auto avail = std::min(n, static_cast<std::streamsize>(egptr() - gptr()));
+
+        std::memcpy(s, gptr(), static_cast<std::size_t>(avail));
+        gbump(static_cast<int>(avail));
+
+        auto got = avail;
+        auto size = static_cast<std::streamsize>(out_.size());
+
+        while (!done_ && n - got >= size)
+            got = decode(s + got) - s;
+
+        return got + std::streambuf::xsgetn(s + got, n - got);
+    }
+};
+} // namespace bizwen